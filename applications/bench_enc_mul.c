@@ -0,0 +1,71 @@
+#include <gghlite/gghlite.h>
+#include <oz/oz.h>
+
+/* multiply random encodings for a generic prime q and for q = 2^k - c·2n + 1 */
+
+static double bench_enc_mul(const size_t lambda, const size_t kappa, const gghlite_flag_t flags, const size_t count,
+                            flint_rand_t randstate, int *status) {
+  gghlite_params_t self;
+  gghlite_params_init(self, lambda, kappa, 0x0, GGHLITE_FLAGS_QUIET | flags);
+
+  gghlite_enc_t f;  gghlite_enc_init(f, self);
+  gghlite_enc_t g;  gghlite_enc_init(g, self);
+  gghlite_enc_t h;  gghlite_enc_init(h, self);
+  fmpz_mod_poly_randtest(f, randstate, self->n);
+  fmpz_mod_poly_randtest(g, randstate, self->n);
+  fmpz_mod_poly_fit_length(f, self->n);
+  fmpz_mod_poly_fit_length(g, self->n);
+
+  uint64_t t = ggh_walltime(0);
+  for(size_t i=0; i<count; i++)
+    gghlite_enc_mul(h, self, f, g);
+  t = ggh_walltime(t);
+
+  /* compare against plain fmpz arithmetic */
+  fmpz_t c;  fmpz_init(c);
+  for(long i=0; i<self->n; i++) {
+    fmpz_mul(c, f->coeffs + i, g->coeffs + i);
+    fmpz_mod(c, c, self->q);
+    *status |= !fmpz_equal(c, h->coeffs + i);
+  }
+  fmpz_clear(c);
+
+  const double rate = count/ggh_seconds(t);
+  printf(" %8s | %6ld | %6ld | %3zu | %7s | %10.1f\n", (flags & GGHLITE_FLAGS_SPARSE_Q) ? "sparse" : "generic",
+         self->n, fmpz_sizeinbase(self->q, 2), self->q_limbs->L,
+         fmpz_mod_oz_limb_ctx_is_special(self->q_limbs) ? "folding" : "barrett", rate);
+
+  gghlite_enc_clear(h);
+  gghlite_enc_clear(g);
+  gghlite_enc_clear(f);
+  gghlite_params_clear(self);
+  return rate;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <λ> <κ> [count]\n", argv[0]);
+    return 1;
+  }
+  const size_t lambda = atol(argv[1]);
+  const size_t kappa = atol(argv[2]);
+  const size_t count = (argc > 3) ? atol(argv[3]) : 16;
+
+  flint_rand_t randstate;
+  flint_randinit(randstate);
+
+  printf(" λ: %3zu, κ: %2zu, count: %4zu, threads: %3d\n", lambda, kappa, count, fmpz_mod_poly_oz_ntt_num_threads());
+  printf("        q |      n | log(q) |   L |  reduce |     muls/s\n");
+
+  int status = 0;
+  const double r0 = bench_enc_mul(lambda, kappa, GGHLITE_FLAGS_DEFAULT, count, randstate, &status);
+  const double r1 = bench_enc_mul(lambda, kappa, GGHLITE_FLAGS_SPARSE_Q, count, randstate, &status);
+  printf(" speedup: %6.2fx\n", r1/r0);
+  if (status)
+    printf("results disagree\n");
+
+  flint_randclear(randstate);
+  flint_cleanup();
+  mpfr_free_cache();
+  return status;
+}
@@ -0,0 +1,77 @@
+#include <oz/oz.h>
+#include <oz/util.h>
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <log n> <log q> [trials]\n", argv[0]);
+    return 1;
+  }
+  const long n = 1L<<atol(argv[1]);
+  const long bits = atol(argv[2]);
+  const long trials = (argc > 3) ? atol(argv[3]) : 4;
+
+  flint_rand_t randstate;
+  flint_randinit(randstate);
+
+  fmpz_t q;  fmpz_init(q);
+  fmpz_mod_poly_oz_rns_modulus(q, n, bits);
+
+  fmpz_mod_poly_oz_rns_precomp_t rns;
+  fmpz_mod_poly_oz_rns_precomp_init(rns, n, q);
+  fmpz_mod_poly_oz_ntt_precomp_t precomp;
+  fmpz_mod_poly_oz_ntt_precomp_init_rns(precomp, rns);
+  const int max_threads = precomp->num_threads;
+
+  fmpz_mod_poly_t f;  fmpz_mod_poly_init(f, q);
+  fmpz_mod_poly_t g;  fmpz_mod_poly_init(g, q);
+  fmpz_mod_poly_t F;  fmpz_mod_poly_init(F, q);
+  fmpz_mod_poly_t G;  fmpz_mod_poly_init(G, q);
+  fmpz_mod_poly_randtest(f, randstate, n);
+  fmpz_mod_poly_randtest(g, randstate, n);
+
+  printf(" n: %6ld, log(q): %5ld, threshold: %5d, trials: %3ld\n", n, fmpz_sizeinbase(q, 2),
+         OZ_NTT_PARALLEL_THRESHOLD, trials);
+  printf(" threads |      enc |      mul |      dec | speedup\n");
+
+  double t1 = 0.0;
+  for(int num_threads=1; num_threads<=max_threads; num_threads *= 2) {
+    precomp->num_threads = num_threads;
+    fmpz_mod_poly_oz_ntt_ws_t ws;
+    fmpz_mod_poly_oz_ntt_ws_init(ws, precomp);
+
+    uint64_t t_enc = 0, t_mul = 0, t_dec = 0;
+    for(long i=0; i<trials; i++) {
+      uint64_t t = oz_walltime(0);
+      fmpz_mod_poly_oz_ntt_enc_ws(F, f, precomp, ws);
+      fmpz_mod_poly_oz_ntt_enc_ws(G, g, precomp, ws);
+      t_enc += oz_walltime(t);
+
+      t = oz_walltime(0);
+      fmpz_mod_poly_oz_ntt_mul_ws(F, F, G, precomp, ws);
+      t_mul += oz_walltime(t);
+
+      t = oz_walltime(0);
+      fmpz_mod_poly_oz_ntt_dec_ws(F, F, precomp, ws);
+      t_dec += oz_walltime(t);
+    }
+    fmpz_mod_poly_oz_ntt_ws_clear(ws);
+    const double total = oz_seconds(t_enc + t_mul + t_dec);
+    if (num_threads == 1)
+      t1 = total;
+    printf(" %7d | %7.4fs | %7.4fs | %7.4fs | %6.2fx\n", num_threads,
+           oz_seconds(t_enc)/trials, oz_seconds(t_mul)/trials, oz_seconds(t_dec)/trials, t1/total);
+    if (num_threads < max_threads && 2*num_threads > max_threads)
+      num_threads = max_threads/2; // always report max_threads
+  }
+
+  fmpz_mod_poly_clear(G);
+  fmpz_mod_poly_clear(F);
+  fmpz_mod_poly_clear(g);
+  fmpz_mod_poly_clear(f);
+  fmpz_mod_poly_oz_ntt_precomp_clear(precomp);
+  fmpz_mod_poly_oz_rns_precomp_clear(rns);
+  fmpz_clear(q);
+  flint_randclear(randstate);
+  flint_cleanup();
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <gghlite/gghlite.h>
+#include <gghlite/gghlite-internals.h>
+#include <oz/oz.h>
+
+#define DISTINCT 8
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    printf("usage: %s <λ> <κ> [count]\n", argv[0]);
+    return 1;
+  }
+  const size_t lambda = atol(argv[1]);
+  const size_t kappa = atol(argv[2]);
+  const size_t count = (argc > 3) ? atol(argv[3]) : 256;
+
+  aes_randstate_t randstate;
+  aes_randinit(randstate);
+
+  gghlite_sk_t self;
+  gghlite_jigsaw_init(self, lambda, kappa, GGHLITE_FLAGS_QUIET, randstate);
+
+  fmpz_t p;  fmpz_init(p);
+  fmpz_poly_oz_ideal_norm(p, self->g, self->params->n, 0);
+
+  /* a few distinct top-level encodings, every other one of zero, repeated to fill the batch */
+  int *group = (int*)calloc(self->params->gamma, sizeof(int));
+  for(size_t k=0; k<kappa; k++)
+    group[k] = 1;
+
+  gghlite_clr_t e;  gghlite_clr_init(e);
+  fmpz_t a;  fmpz_init(a);
+  gghlite_enc_t u[DISTINCT];
+  for(size_t i=0; i<DISTINCT; i++) {
+    gghlite_enc_init(u[i], self->params);
+    fmpz_poly_zero(e);
+    if (i&1) {
+      fmpz_randm_aes(a, randstate, p);
+      fmpz_poly_set_coeff_fmpz(e, 0, a);
+    }
+    gghlite_enc_set_gghlite_clr(u[i], self, e, 1, group, 1);
+  }
+
+  gghlite_enc_t *ops = (gghlite_enc_t*)calloc(count, sizeof(gghlite_enc_t));
+  for(size_t i=0; i<count; i++) {
+    gghlite_enc_init(ops[i], self->params);
+    gghlite_enc_set(ops[i], u[i%DISTINCT]);
+  }
+
+  int *r0 = (int*)calloc(count, sizeof(int));
+  int *r1 = (int*)calloc(count, sizeof(int));
+
+  printf(" λ: %3zu, κ: %2zu, n: %6ld, log(q): %6ld, count: %6zu, threads: %3d\n", lambda, kappa,
+         self->params->n, fmpz_sizeinbase(self->params->q, 2), count, self->params->ntt->num_threads);
+
+  uint64_t t = ggh_walltime(0);
+  for(size_t i=0; i<count; i++)
+    r0[i] = gghlite_enc_is_zero(self->params, ops[i]);
+  t = ggh_walltime(t);
+  printf("   serial: %10.1f zero-tests/s\n", count/ggh_seconds(t));
+
+  gghlite_enc_ws_t ws;
+  gghlite_enc_ws_init(ws, self->params);
+  t = ggh_walltime(0);
+  for(size_t i=0; i<count; i++)
+    r1[i] = gghlite_enc_is_zero_ws(self->params, ops[i], ws);
+  t = ggh_walltime(t);
+  gghlite_enc_ws_clear(ws);
+  printf("       ws: %10.1f zero-tests/s\n", count/ggh_seconds(t));
+
+  int status = memcmp(r0, r1, count*sizeof(int)) != 0;
+
+  t = ggh_walltime(0);
+  gghlite_enc_is_zero_batch(r1, self->params, (const gghlite_enc_t *)ops, count);
+  t = ggh_walltime(t);
+  printf("    batch: %10.1f zero-tests/s\n", count/ggh_seconds(t));
+
+  status |= memcmp(r0, r1, count*sizeof(int)) != 0;
+  for(size_t i=0; i<count; i++)
+    status |= (r0[i] != !((i%DISTINCT)&1));
+  if (status)
+    printf("results disagree\n");
+
+  free(r0);
+  free(r1);
+  for(size_t i=0; i<count; i++)
+    gghlite_enc_clear(ops[i]);
+  free(ops);
+  for(size_t i=0; i<DISTINCT; i++)
+    gghlite_enc_clear(u[i]);
+  fmpz_clear(a);
+  gghlite_clr_clear(e);
+  free(group);
+  fmpz_clear(p);
+  gghlite_sk_clear(self, 1);
+  aes_randclear(randstate);
+  flint_cleanup();
+  mpfr_free_cache();
+  return status;
+}
@@ -34,6 +34,8 @@ int main(int argc, char *argv[]) {
 
   gghlite_clr_t out;
   gghlite_clr_init(out);
+  gghlite_enc_ws_t ws;
+  gghlite_enc_ws_init(ws, self->params);
 
   mpfr_t norm;
   mpfr_init2(norm, _gghlite_prec(self->params));
@@ -56,7 +58,7 @@ int main(int argc, char *argv[]) {
       gghlite_enc_raise0(u[k], self->params, u[k], 1, randstate);
       gghlite_enc_mul(tmp, self->params, tmp, u[k]);
     }
-    _gghlite_enc_extract_raw(out, self->params, tmp);
+    _gghlite_enc_extract_raw(out, self->params, tmp, ws);
     fmpz_poly_2norm_mpfr(norm, out, MPFR_RNDN);
     mpfr_add(acc, acc, norm, MPFR_RNDN);
     if (mpfr_cmp(norm, max)>0)
@@ -77,6 +79,7 @@ int main(int argc, char *argv[]) {
       gghlite_enc_clear(u[k]);
 
   free(u);
+  gghlite_enc_ws_clear(ws);
 
   gghlite_sk_clear(self, 1);
 
@@ -0,0 +1,43 @@
+#include <gghlite/gghlite.h>
+#include <gghlite/gghlite-internals.h>
+
+int main(int argc, char *argv[]) {
+  if (argc < 6) {
+    printf("usage: %s <cache> <λ_min> <λ_max> <λ_step> <κ_max> [rerand] [flags]\n", argv[0]);
+    printf("adds parameters for λ_min ≤ λ ≤ λ_max and 2 ≤ κ = γ ≤ κ_max to <cache>,\n");
+    printf("use it by setting %s=<cache>\n", GGHLITE_PARAMS_CACHE_ENV);
+    return 1;
+  }
+  const char *path = argv[1];
+  const size_t lambda_min = atol(argv[2]);
+  const size_t lambda_max = atol(argv[3]);
+  const size_t lambda_step = atol(argv[4]);
+  const size_t kappa_max = atol(argv[5]);
+  const uint64_t rerand = (argc > 6) ? strtoul(argv[6], NULL, 0) : 0x0;
+  const gghlite_flag_t flags = (gghlite_flag_t)((argc > 7) ? strtoul(argv[7], NULL, 0) : GGHLITE_FLAGS_DEFAULT);
+
+  if (!lambda_min || lambda_max < lambda_min || !lambda_step || kappa_max < 2) {
+    printf("invalid range\n");
+    return 1;
+  }
+
+  int status = 0;
+  for(size_t lambda=lambda_min; lambda<=lambda_max; lambda+=lambda_step) {
+    for(size_t kappa=2; kappa<=kappa_max; kappa++) {
+      gghlite_params_t self;
+      uint64_t t = ggh_walltime(0);
+      gghlite_params_init_gamma(self, lambda, kappa, kappa, rerand, (gghlite_flag_t)(flags | GGHLITE_FLAGS_QUIET));
+      t = ggh_walltime(t);
+
+      const int r = gghlite_params_cache_add(path, self);
+      printf(" λ: %3zu, κ: %2zu, n: %6ld, log(q): %6ld, %8.2fs%s\n", lambda, kappa, self->n,
+             fmpz_sizeinbase(self->q, 2), ggh_seconds(t), r ? " (write failed)" : "");
+      status |= r;
+      gghlite_params_clear(self);
+    }
+  }
+
+  flint_cleanup();
+  mpfr_free_cache();
+  return status ? 1 : 0;
+}
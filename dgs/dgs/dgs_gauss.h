@@ -597,6 +597,26 @@ void dgs_disc_gauss_mp_call_uniform_online(mpz_t rop, dgs_disc_gauss_mp_t *self,
 
 void dgs_disc_gauss_mp_call_sigma2_logtable(mpz_t rop, dgs_disc_gauss_mp_t *self, aes_randstate_t state);
 
+/**
+  Sample from ``dgs_disc_gauss_mp_t`` with centre `c` instead of ``self->c``.
+
+  This avoids creating a new sampler for each centre, since no precomputed
+  data of ``DGS_DISC_GAUSS_UNIFORM_ONLINE`` depends on `c`. The centre of
+  ``self`` is replaced by `c`.
+
+  :param rop: target value.
+  :param self: discrete Gaussian sampler.
+  :param c: centre of the distribution.
+  :param state: entropy pool.
+
+  .. note::
+
+     Algorithms other than ``DGS_DISC_GAUSS_UNIFORM_ONLINE`` precompute data
+     for `c % 1` and thus require `c % 1 == self->c % 1`.
+ */
+
+void dgs_disc_gauss_mp_call_centered(mpz_t rop, dgs_disc_gauss_mp_t *self, const mpfr_t c, aes_randstate_t state);
+
 /**
    Clear cache of random bits.
 
@@ -415,6 +415,21 @@ void dgs_disc_gauss_mp_call_sigma2_logtable(mpz_t rop, dgs_disc_gauss_mp_t *self
   mpz_add(rop, rop, self->c_z);
 }
 
+void dgs_disc_gauss_mp_call_centered(mpz_t rop, dgs_disc_gauss_mp_t *self, const mpfr_t c, aes_randstate_t state) {
+  mpfr_set(self->c, c, MPFR_RNDN);
+  mpfr_get_z(self->c_z, self->c, MPFR_RNDN);
+
+  if (self->algorithm == DGS_DISC_GAUSS_UNIFORM_ONLINE) {
+    mpfr_sub_z(self->c_r, self->c, self->c_z, MPFR_RNDN);
+  } else {
+    /* c_r is baked into the precomputed data, only the integer part may change */
+    mpfr_sub_z(self->z, self->c, self->c_z, MPFR_RNDN);
+    if (!mpfr_equal_p(self->z, self->c_r))
+      dgs_die("changing c%%1 requires DGS_DISC_GAUSS_UNIFORM_ONLINE");
+  }
+  self->call(rop, self, state);
+}
+
 /** GENERAL SIGMA :: CLEAR **/
 
 void dgs_disc_gauss_mp_clear(dgs_disc_gauss_mp_t *self) {
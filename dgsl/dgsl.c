@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <float.h>
+#include <math.h>
 #include <mpfr.h>
 #include <omp.h>
 #include <dgs/dgs.h>
@@ -242,6 +244,33 @@ void dgsl_mp_clear(dgsl_mp_t *self) {
    Rotational Basis
 **/
 
+/* rop = ⌊op·2^k⌋ */
+
+static void _fmpz_poly_set_fmpq_poly_2exp(fmpz_poly_t rop, const fmpq_poly_t op, const mp_bitcnt_t k) {
+  fmpq_poly_get_numerator(rop, op);
+  fmpz_poly_scalar_mul_2exp(rop, rop, k);
+  fmpz_poly_scalar_fdiv_fmpz(rop, rop, fmpq_poly_denref(op));
+}
+
+/* fixed-point copies of B_inv and sigma_sqrt, so that sampling avoids fmpq_poly arithmetic and its
+   gcd normalisation; the extra prec bits keep the small coefficients of B_inv accurate */
+
+static void _dgsl_rot_mp_init_fix(dgsl_rot_mp_t *self) {
+  self->fix = 2*self->prec;
+  fmpz_poly_init(self->B_inv_z);
+  _fmpz_poly_set_fmpq_poly_2exp(self->B_inv_z, self->B_inv, self->fix);
+  fmpz_poly_init(self->sigma_sqrt_z);
+  _fmpz_poly_set_fmpq_poly_2exp(self->sigma_sqrt_z, self->sigma_sqrt, self->fix);
+}
+
+/* rop = sigma_sqrt·x·2^fix with x ← D_1 */
+
+static void _dgsl_rot_mp_sample_sigma_sqrt(fmpz_poly_t rop, const dgsl_rot_mp_t *self, aes_randstate_t state) {
+  fmpz_poly_sample_D1_2exp(rop, self->n, self->prec, state);
+  fmpz_poly_oz_mul(rop, self->sigma_sqrt_z, rop, self->n);
+  fmpz_poly_scalar_fdiv_2exp(rop, rop, self->prec);
+}
+
 dgsl_rot_mp_t *dgsl_rot_mp_init(const long n, const fmpz_poly_t B, mpfr_t sigma, fmpq_poly_t c, const dgsl_alg_t algorithm, const oz_flag_t flags) {
   assert(mpfr_cmp_ui(sigma, 0) > 0);
 
@@ -332,6 +361,10 @@ dgsl_rot_mp_t *dgsl_rot_mp_init(const long n, const fmpz_poly_t B, mpfr_t sigma,
     mpfr_clear(c_);
     mpfr_mat_clear(G);
 
+    self->z = (fmpz_poly_struct*)malloc(sizeof(fmpz_poly_struct));
+    if(!self->z) dgs_die("out of memory");
+    fmpz_poly_init2(self->z, n);
+
     self->call = dgsl_rot_mp_call_gpv_inlattice;
     break;
   }
@@ -349,6 +382,8 @@ dgsl_rot_mp_t *dgsl_rot_mp_init(const long n, const fmpz_poly_t B, mpfr_t sigma,
     mpfr_init2(self->r_f, self->prec);
     mpfr_set_ui(self->r_f, r, MPFR_RNDN);
 
+    _dgsl_rot_mp_init_fix(self);
+
     self->call = dgsl_rot_mp_call_inlattice;
     break;
   }
@@ -364,6 +399,45 @@ dgsl_rot_mp_t *dgsl_rot_mp_init(const long n, const fmpz_poly_t B, mpfr_t sigma,
 }
 
 
+dgsl_rot_mp_t *dgsl_rot_mp_init_inlattice(const long n, const fmpz_poly_t B, mpfr_t sigma,
+                                          const fmpq_poly_t B_inv, const fmpq_poly_t sigma_sqrt) {
+  assert(mpfr_cmp_ui(sigma, 0) > 0);
+
+  dgsl_rot_mp_t *self = (dgsl_rot_mp_t*)calloc(1, sizeof(dgsl_rot_mp_t));
+  if(!self) dgs_die("out of memory");
+
+  self->n = n;
+  self->prec = mpfr_get_prec(sigma);
+
+  fmpz_poly_init(self->B);
+  fmpz_poly_set(self->B, B);
+  if(fmpz_poly_length(self->B) > n)
+    dgs_die("polynomial is longer than length n");
+  else
+    fmpz_poly_realloc(self->B, n);
+
+  fmpz_poly_init(self->c_z);
+  fmpq_poly_init(self->c);
+
+  mpfr_init2(self->sigma, self->prec);
+  mpfr_set(self->sigma, sigma, MPFR_RNDN);
+
+  fmpq_poly_init(self->B_inv);
+  fmpq_poly_set(self->B_inv, B_inv);
+  fmpq_poly_init(self->sigma_sqrt);
+  fmpq_poly_set(self->sigma_sqrt, sigma_sqrt);
+
+  /* same choice as in dgsl_rot_mp_init() */
+  long r = 2*ceil(sqrt(log(n)));
+  mpfr_init2(self->r_f, self->prec);
+  mpfr_set_ui(self->r_f, r, MPFR_RNDN);
+
+  _dgsl_rot_mp_init_fix(self);
+
+  self->call = dgsl_rot_mp_call_inlattice;
+  return self;
+}
+
 int dgsl_rot_mp_call_identity(fmpz_poly_t rop,  const dgsl_rot_mp_t *self, aes_randstate_t state) {
   assert(rop); assert(self);
 
@@ -390,98 +464,208 @@ int dgsl_rot_mp_call_gpv_inlattice(fmpz_poly_t rop,  const dgsl_rot_mp_t *self,
 
   const long n = self->n;
   mpz_t  tmp_z; mpz_init(tmp_z);
-  fmpz_t tmp; fmpz_init(tmp);
-
-  fmpz_poly_zero(rop);
-
-  fmpz_poly_t tmp_poly;
-  fmpz_poly_init(tmp_poly);
-  fmpz_poly_set(tmp_poly, self->B);
-  fmpz_poly_realloc(tmp_poly, n);
-  tmp_poly->length = n;
-
-  fmpz_poly_t tmp2;
-  fmpz_poly_init(tmp2);
 
+  /* Σ z_i·x^i·B mod x^n+1 is (Σ z_i·x^i)·B, so sample all z_i first and multiply once */
+  fmpz_poly_struct *z = self->z;
+  fmpz_poly_fit_length(z, n);
   for(long i=0; i<n; i++) {
-    self->D[i]->call(tmp_z, self->D[i], state); fmpz_set_mpz(tmp, tmp_z);
-    fmpz_poly_scalar_mul_fmpz(tmp2, tmp_poly, tmp);
-    fmpz_poly_add(rop, rop, tmp2);
-    _fmpz_vec_rot_left_neg(tmp_poly->coeffs, tmp_poly->coeffs, n);
+    self->D[i]->call(tmp_z, self->D[i], state);
+    fmpz_set_mpz(z->coeffs + i, tmp_z);
   }
-  fmpz_poly_clear(tmp_poly);
+  _fmpz_poly_set_length(z, n);
+  _fmpz_poly_normalise(z);
+
+  fmpz_poly_oz_mul(rop, self->B, z, n);
   fmpz_poly_add(rop, rop, self->c_z);
 
-  fmpz_poly_clear(tmp2);
   mpz_clear(tmp_z);
-  fmpz_clear(tmp);
   return 0;
 }
 
 int dgsl_rot_mp_call_plus1(fmpz_poly_t rop, const dgsl_rot_mp_t *self, aes_randstate_t state) {
-  const long n = self->n;
-  fmpq_poly_t x;
-  fmpq_poly_init(x);
-  fmpq_poly_sample_D1(x, n, self->prec, state);
-  fmpq_poly_oz_mul(x, self->sigma_sqrt, x, self->n);
-  fmpq_poly_neg(x, x); // (-x2)
+  fmpz_poly_t x;
+  fmpz_poly_init(x);
+  _dgsl_rot_mp_sample_sigma_sqrt(x, self, state);
+  fmpz_poly_neg(x, x); // (-x2)
 
   // we sample with centre c = -1/g
-  fmpq_poly_sub(x, x, self->B_inv); // (c+x2)
+  fmpz_poly_sub(x, x, self->B_inv_z); // (c+x2)
 
-  fmpz_poly_disc_gauss_rounding(rop, x, self->r_f, state);
+  fmpz_poly_disc_gauss_rounding_2exp(rop, x, self->fix, self->r_f, state);
   fmpz_poly_neg(rop, rop);
   fmpz_poly_oz_mul(rop, self->B, rop, self->n);
   fmpz_add_ui(rop->coeffs, rop->coeffs, 1);
 
-  fmpq_poly_clear(x);
+  fmpz_poly_clear(x);
   return 0;
 }
 
-int dgsl_rot_mp_call_plus_fmpz_poly(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpz_poly_t c, aes_randstate_t state) {
+/* take one perturbation from the pool, blocks while the pool is empty */
+
+static void _dgsl_rot_mp_pool_get(fmpz_poly_t x, dgsl_rot_mp_pool_t *pool) {
+  pthread_mutex_lock(&pool->lock);
+  while(pool->len == 0)
+    pthread_cond_wait(&pool->not_empty, &pool->lock);
+  fmpz_poly_swap(x, pool->x[pool->head]);
+  pool->head = (pool->head + 1) % pool->size;
+  pool->len--;
+  if (pool->len <= pool->low)
+    pthread_cond_signal(&pool->refill);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/* pool may be NULL, in which case the perturbation is sampled here */
+
+static int _dgsl_rot_mp_call_recenter_fmpq_poly(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpq_poly_t c,
+                                                dgsl_rot_mp_pool_t *pool, aes_randstate_t state) {
+  fmpz_poly_t x;
+  fmpz_poly_init(x);
+  if (pool)
+    _dgsl_rot_mp_pool_get(x, pool);
+  else
+    _dgsl_rot_mp_sample_sigma_sqrt(x, self, state);
+  fmpz_poly_neg(x, x);
+
+  // we sample with centre c/g
+  fmpz_poly_t t;  fmpz_poly_init(t);
+  fmpq_poly_get_numerator(t, c);
+  fmpz_poly_oz_mul(t, t, self->B_inv_z, self->n);
+  if (!fmpz_is_one(fmpq_poly_denref(c)))
+    fmpz_poly_scalar_fdiv_fmpz(t, t, fmpq_poly_denref(c));
+  fmpz_poly_add(x, t, x); // (c+x2)
+  fmpz_poly_clear(t);
+
+  fmpz_poly_disc_gauss_rounding_2exp(rop, x, self->fix, self->r_f, state);
+  fmpz_poly_oz_mul(rop, self->B, rop, self->n);
+
+  fmpz_poly_clear(x);
+  return 0;
+}
+
+static int _dgsl_rot_mp_call_plus_fmpz_poly(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpz_poly_t c,
+                                            dgsl_rot_mp_pool_t *pool, aes_randstate_t state) {
   fmpz_poly_t t;  fmpz_poly_init(t);
   fmpz_poly_set(t, c);
   fmpq_poly_t tq; fmpq_poly_init(tq); // == 0
   fmpq_poly_set_fmpz_poly(tq, t);
   fmpq_poly_neg(tq, tq);
-  dgsl_rot_mp_call_recenter_fmpq_poly(rop, self, tq, state);
+  _dgsl_rot_mp_call_recenter_fmpq_poly(rop, self, tq, pool, state);
   fmpz_poly_add(rop, rop, t);
   fmpq_poly_clear(tq);
   fmpz_poly_clear(t);
   return 0;
 }
 
+int dgsl_rot_mp_call_plus_fmpz_poly(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpz_poly_t c, aes_randstate_t state) {
+  return _dgsl_rot_mp_call_plus_fmpz_poly(rop, self, c, NULL, state);
+}
+
 int dgsl_rot_mp_call_recenter_fmpq_poly(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpq_poly_t c, aes_randstate_t state) {
-  fmpq_poly_t x;
-  fmpq_poly_init(x);
-  fmpq_poly_sample_D1(x, self->n, self->prec, state);
-  fmpq_poly_oz_mul(x, self->sigma_sqrt, x, self->n);
-  fmpq_poly_neg(x, x);
+  return _dgsl_rot_mp_call_recenter_fmpq_poly(rop, self, c, NULL, state);
+}
 
-  // we sample with centre c/g
-  fmpq_poly_t t;  fmpq_poly_init(t);
-  fmpq_poly_oz_mul(t, c, self->B_inv, self->n);
-  fmpq_poly_add(x, t, x); // (c+x2)
-  fmpq_poly_clear(t);
+int dgsl_rot_mp_call_plus_fmpz_poly_pool(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpz_poly_t c,
+                                         dgsl_rot_mp_pool_t *pool, aes_randstate_t state) {
+  assert(pool->D == self);
+  return _dgsl_rot_mp_call_plus_fmpz_poly(rop, self, c, pool, state);
+}
 
-  fmpz_poly_disc_gauss_rounding(rop, x, self->r_f, state);
-  fmpz_poly_oz_mul(rop, self->B, rop, self->n);
+int dgsl_rot_mp_call_recenter_fmpq_poly_pool(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpq_poly_t c,
+                                             dgsl_rot_mp_pool_t *pool, aes_randstate_t state) {
+  assert(pool->D == self);
+  return _dgsl_rot_mp_call_recenter_fmpq_poly(rop, self, c, pool, state);
+}
 
-  fmpq_poly_clear(x);
-  return 0;
+/* background thread: fill the pool up to its capacity, then sleep until it drained down to pool->low */
+
+static void *_dgsl_rot_mp_pool_worker(void *arg) {
+  dgsl_rot_mp_pool_t *pool = (dgsl_rot_mp_pool_t*)arg;
+  fmpz_poly_t x;
+  fmpz_poly_init(x);
 
+  pthread_mutex_lock(&pool->lock);
+  while(!pool->stop) {
+    if (pool->len == pool->size) {
+      while(!pool->stop && pool->len > pool->low)
+        pthread_cond_wait(&pool->refill, &pool->lock);
+      continue;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    _dgsl_rot_mp_sample_sigma_sqrt(x, pool->D, pool->rng);
+    pthread_mutex_lock(&pool->lock);
+    fmpz_poly_swap(pool->x[(pool->head + pool->len) % pool->size], x);
+    pool->len++;
+    pthread_cond_signal(&pool->not_empty);
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  fmpz_poly_clear(x);
+  flint_cleanup();
+  mpfr_free_cache();
+  return NULL;
+}
+
+dgsl_rot_mp_pool_t *dgsl_rot_mp_pool_init(const dgsl_rot_mp_t *self, const size_t size, const size_t low,
+                                          aes_randstate_t state) {
+  if (self->call != dgsl_rot_mp_call_inlattice)
+    dgs_die("perturbation pools require DGSL_INLATTICE");
+  if (low >= size)
+    dgs_die("pool requires low < size");
+
+  dgsl_rot_mp_pool_t *pool = (dgsl_rot_mp_pool_t*)calloc(1, sizeof(dgsl_rot_mp_pool_t));
+  if(!pool) dgs_die("out of memory");
+
+  pool->D = self;
+  pool->size = size;
+  pool->low = low;
+  pool->x = (fmpz_poly_t*)malloc(size * sizeof(fmpz_poly_t));
+  if(!pool->x) dgs_die("out of memory");
+  for(size_t i=0; i<size; i++)
+    fmpz_poly_init(pool->x[i]);
+
+  size_t nbytes;
+  unsigned char *buf = random_aes(state, 128, &nbytes);
+  aes_randinit_seedn(pool->rng, (char *) buf, nbytes, NULL, 0);
+  free(buf);
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->not_empty, NULL);
+  pthread_cond_init(&pool->refill, NULL);
+
+  if (pthread_create(&pool->thread, NULL, _dgsl_rot_mp_pool_worker, pool))
+    dgs_die("could not start pool thread");
+  return pool;
+}
+
+void dgsl_rot_mp_pool_clear(dgsl_rot_mp_pool_t *pool) {
+  if (!pool)
+    return;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = 1;
+  pthread_cond_signal(&pool->refill);
+  pthread_mutex_unlock(&pool->lock);
+  pthread_join(pool->thread, NULL);
+
+  pthread_cond_destroy(&pool->refill);
+  pthread_cond_destroy(&pool->not_empty);
+  pthread_mutex_destroy(&pool->lock);
+
+  for(size_t i=0; i<pool->size; i++)
+    fmpz_poly_clear(pool->x[i]);
+  free(pool->x);
+  aes_randclear(pool->rng);
+  free(pool);
 }
 
 int _dgsl_rot_mp_call_inlattice_multiplier(fmpz_poly_t rop, const dgsl_rot_mp_t *self, aes_randstate_t state) {
-  const long n = self->n;
-  fmpq_poly_t x;
-  fmpq_poly_init(x);
-  fmpq_poly_sample_D1(x, n, self->prec, state);
-  fmpq_poly_oz_mul(x, self->sigma_sqrt, x, self->n);
-  fmpq_poly_neg(x, x);;
-  fmpz_poly_disc_gauss_rounding(rop, x, self->r_f, state);
-  fmpz_poly_neg(rop, rop);;
-  fmpq_poly_clear(x);
+  fmpz_poly_t x;
+  fmpz_poly_init(x);
+  _dgsl_rot_mp_sample_sigma_sqrt(x, self, state);
+  fmpz_poly_neg(x, x);
+  fmpz_poly_disc_gauss_rounding_2exp(rop, x, self->fix, self->r_f, state);
+  fmpz_poly_neg(rop, rop);
+  fmpz_poly_clear(x);
   return 0;
 }
 
@@ -511,11 +695,19 @@ void dgsl_rot_mp_clear(dgsl_rot_mp_t *self) {
     }
   }
   if(self->call == dgsl_rot_mp_call_gpv_inlattice) {
-
+    if(self->D) {
+      for(long i=0; i<self->n; i++)
+        dgs_disc_gauss_mp_clear(self->D[i]);
+      free(self->D);
+    }
+    fmpz_poly_clear(self->z);
+    free(self->z);
   }
   if(self->call == dgsl_rot_mp_call_inlattice) {
     mpfr_clear(self->r_f);
     fmpq_poly_clear(self->sigma_sqrt);
+    fmpz_poly_clear(self->sigma_sqrt_z);
+    fmpz_poly_clear(self->B_inv_z);
   }
   mpfr_clear(self->sigma);
   free(self);
@@ -532,24 +724,91 @@ void fmpz_poly_disc_gauss_rounding(fmpz_poly_t rop, const fmpq_poly_t x, const m
 
   fmpz_poly_zero(rop);
 
+  // only the centre changes between coefficients, so we set up one sampler and re-centre it
+  mpfr_set_zero(xi, 0);
+  dgs_disc_gauss_mp_t *D = dgs_disc_gauss_mp_init(r_f, xi, tau, DGS_DISC_GAUSS_UNIFORM_ONLINE);
+
   for(int i=0; i<n; i++) {
     fmpq_poly_get_coeff_mpq(xi_q, x, i);
     mpf_set_q(xi_f, xi_q);
     mpfr_set_f(xi, xi_f, MPFR_RNDN);
 
-    dgs_disc_gauss_mp_t *D = dgs_disc_gauss_mp_init(r_f, xi, tau, DGS_DISC_GAUSS_UNIFORM_ONLINE);
-    D->call(s_z, D, randstate);
-    dgs_disc_gauss_mp_clear(D);
+    dgs_disc_gauss_mp_call_centered(s_z, D, xi, randstate);
 
     fmpz_poly_set_coeff_mpz(rop, i, s_z);
   }
+  dgs_disc_gauss_mp_clear(D);
   mpz_clear(s_z);
   mpq_clear(xi_q);
   mpf_clear(xi_f);
   mpfr_clear(xi);
 }
 
-void fmpq_poly_sample_D1(fmpq_poly_t f, int n, mpfr_prec_t prec, aes_randstate_t state) {
+void fmpz_poly_disc_gauss_rounding_2exp(fmpz_poly_t rop, const fmpz_poly_t x, const mp_bitcnt_t k,
+                                        const mpfr_t r_f, aes_randstate_t randstate) {
+  mpfr_t xi;  mpfr_init2(xi, mpfr_get_prec(r_f));
+  mpz_t xi_z; mpz_init(xi_z);
+  mpz_t s_z;  mpz_init(s_z);
+
+  const long n = fmpz_poly_length(x);
+  const size_t tau = (ceil(2*sqrt(log2((double)n))) > 3) ? ceil(2*sqrt(log2((double)n))) : 3;
+
+  fmpz_poly_zero(rop);
+
+  mpfr_set_zero(xi, 0);
+  dgs_disc_gauss_mp_t *D = dgs_disc_gauss_mp_init(r_f, xi, tau, DGS_DISC_GAUSS_UNIFORM_ONLINE);
+
+  for(int i=0; i<n; i++) {
+    fmpz_get_mpz(xi_z, x->coeffs + i);
+    mpfr_set_z_2exp(xi, xi_z, -(long)k, MPFR_RNDN);
+
+    dgs_disc_gauss_mp_call_centered(s_z, D, xi, randstate);
+
+    fmpz_poly_set_coeff_mpz(rop, i, s_z);
+  }
+  dgs_disc_gauss_mp_clear(D);
+  mpz_clear(s_z);
+  mpz_clear(xi_z);
+  mpfr_clear(xi);
+}
+
+/* Box-Muller in double precision, writes n numerators with denominator 2^prec into num */
+
+static void _fmpz_vec_sample_D1_d(fmpz *num, const long n, const mpfr_prec_t prec, aes_randstate_t state) {
+  double *u1 = (double*)malloc(n/2 * sizeof(double));
+  double *u2 = (double*)malloc(n/2 * sizeof(double));
+
+  /* one call to the AES PRNG for all uniforms, DBL_MANT_DIG bits each from the top of a limb */
+  mpz_t r;  mpz_init(r);
+  mpz_urandomb_aes(r, state, n * GMP_NUMB_BITS);
+  for(long i=0; i<n/2; i++) {
+    const mp_limb_t a = mpz_getlimbn(r, 2*i+0) >> (GMP_NUMB_BITS - DBL_MANT_DIG);
+    const mp_limb_t b = mpz_getlimbn(r, 2*i+1) >> (GMP_NUMB_BITS - DBL_MANT_DIG);
+    u1[i] = ldexp((double)(a + 1), -DBL_MANT_DIG); // (0,1] so that log(u1) is finite
+    u2[i] = ldexp((double)b, -DBL_MANT_DIG);
+  }
+  mpz_clear(r);
+
+#pragma omp simd
+  for(long i=0; i<n/2; i++) {
+    const double rho = sqrt(-2.0 * log(u1[i]));
+    const double theta = 2.0 * M_PI * u2[i];
+    u1[i] = rho * cos(theta); // z1 = sqrt(-2*log(u1)) * cos(2*pi*u2)
+    u2[i] = rho * sin(theta); // z2 = sqrt(-2*log(u1)) * sin(2*pi*u2)
+  }
+
+  /* |z| < 9 so z·2^prec fits into a signed 64-bit integer for prec ≤ DBL_MANT_DIG */
+  for(long i=0; i<n/2; i++) {
+    fmpz_set_si(num + 2*i+0, (slong)llround(ldexp(u1[i], prec)));
+    fmpz_set_si(num + 2*i+1, (slong)llround(ldexp(u2[i], prec)));
+  }
+  free(u1);
+  free(u2);
+}
+
+/* Box-Muller in MPFR, writes n numerators with denominator 2^prec into num */
+
+static void _fmpz_vec_sample_D1_mpfr(fmpz *num, const long n, const mpfr_prec_t prec, aes_randstate_t state) {
   mpfr_t u1; mpfr_init2(u1, prec);
   mpfr_t u2; mpfr_init2(u2, prec);
   mpfr_t z1; mpfr_init2(z1, prec);
@@ -559,12 +818,8 @@ void fmpq_poly_sample_D1(fmpq_poly_t f, int n, mpfr_prec_t prec, aes_randstate_t
   mpfr_const_pi(pi2, MPFR_RNDN);
   mpfr_mul_si(pi2, pi2, 2, MPFR_RNDN);
 
-  mpf_t tmp_f;
-  mpq_t tmp_q;
-  mpf_init(tmp_f);
-  mpq_init(tmp_q);
-
-  assert(n%2==0);
+  mpz_t tmp_z;
+  mpz_init(tmp_z);
 
   for(long i=0; i<n; i+=2) {
     mpfr_urandomb_aes(u1, state);
@@ -578,16 +833,15 @@ void fmpq_poly_sample_D1(fmpq_poly_t f, int n, mpfr_prec_t prec, aes_randstate_t
     mpfr_sin(z2, u2, MPFR_RNDN);
     mpfr_mul(z2, z2, u1, MPFR_RNDN); //z1 = sqrt(-2*log(u1)) * sin(2*pi*U2)
 
-    mpfr_get_f(tmp_f, z1, MPFR_RNDN);
-    mpq_set_f(tmp_q, tmp_f);
-    fmpq_poly_set_coeff_mpq(f, i, tmp_q);
+    mpfr_mul_2si(z1, z1, prec, MPFR_RNDN);
+    mpfr_get_z(tmp_z, z1, MPFR_RNDN);
+    fmpz_set_mpz(num + i, tmp_z);
 
-    mpfr_get_f(tmp_f, z2, MPFR_RNDN);
-    mpq_set_f(tmp_q, tmp_f);
-    fmpq_poly_set_coeff_mpq(f, i+1, tmp_q);
+    mpfr_mul_2si(z2, z2, prec, MPFR_RNDN);
+    mpfr_get_z(tmp_z, z2, MPFR_RNDN);
+    fmpz_set_mpz(num + i + 1, tmp_z);
   }
-  mpf_clear(tmp_f);
-  mpq_clear(tmp_q);
+  mpz_clear(tmp_z);
   mpfr_clear(pi2);
   mpfr_clear(u1);
   mpfr_clear(u2);
@@ -595,6 +849,39 @@ void fmpq_poly_sample_D1(fmpq_poly_t f, int n, mpfr_prec_t prec, aes_randstate_t
   mpfr_clear(z2);
 }
 
+void fmpq_poly_sample_D1(fmpq_poly_t f, int n, mpfr_prec_t prec, aes_randstate_t state) {
+  assert(n%2==0);
+
+  /* sample numerators over the common denominator 2^prec directly into f */
+  fmpq_poly_zero(f);
+  fmpq_poly_fit_length(f, n);
+
+  if (prec <= DBL_MANT_DIG && GMP_NUMB_BITS >= DBL_MANT_DIG)
+    _fmpz_vec_sample_D1_d(f->coeffs, n, prec, state);
+  else
+    _fmpz_vec_sample_D1_mpfr(f->coeffs, n, prec, state);
+
+  fmpz_one(f->den);
+  fmpz_mul_2exp(f->den, f->den, prec);
+  _fmpq_poly_set_length(f, n);
+  fmpq_poly_canonicalise(f);
+}
+
+void fmpz_poly_sample_D1_2exp(fmpz_poly_t f, int n, mpfr_prec_t prec, aes_randstate_t state) {
+  assert(n%2==0);
+
+  fmpz_poly_zero(f);
+  fmpz_poly_fit_length(f, n);
+
+  if (prec <= DBL_MANT_DIG && GMP_NUMB_BITS >= DBL_MANT_DIG)
+    _fmpz_vec_sample_D1_d(f->coeffs, n, prec, state);
+  else
+    _fmpz_vec_sample_D1_mpfr(f->coeffs, n, prec, state);
+
+  _fmpz_poly_set_length(f, n);
+  _fmpz_poly_normalise(f);
+}
+
 /**
    sqrt(Σ_2) with Σ_2 = Σ - Σ_1 = σ^2·g^-T·g^-1 - r^2·I
 */
@@ -1,6 +1,7 @@
 #ifndef DGSL__H
 #define DGSL__H
 
+#include <pthread.h>
 #include <mpfr.h>
 #include <dgs/dgs.h>
 #include <flint/fmpz_mat.h>
@@ -43,8 +44,36 @@ typedef struct _dgsl_rot_mp_t{
   fmpq_poly_t sigma_sqrt;
   mpfr_prec_t prec;
 
+  mp_bitcnt_t fix;          //< fixed-point scale of `B_inv_z` and `sigma_sqrt_z`
+  fmpz_poly_t B_inv_z;      //< `B_inv·2^fix` rounded
+  fmpz_poly_t sigma_sqrt_z; //< `sigma_sqrt·2^fix` rounded
+
+  fmpz_poly_struct *z;      //< scratch space for the multiplier in `DGSL_GPV_INLATTICE`
+
 } dgsl_rot_mp_t;
 
+/**
+   @brief Pool of centre-independent perturbations `sigma_sqrt·x·2^fix` with `x ← D_1`.
+
+   A background thread keeps the pool filled, so that sampling with a pool only pays for the
+   centre-dependent part.
+*/
+
+typedef struct _dgsl_rot_mp_pool_t {
+  const dgsl_rot_mp_t *D;   //< sampler the perturbations are for
+  fmpz_poly_t *x;           //< ring buffer of perturbations
+  size_t size;              //< capacity of the ring buffer
+  size_t low;               //< refill once no more than `low` perturbations are left
+  size_t head;              //< index of the next perturbation to hand out
+  size_t len;               //< number of perturbations available
+  int stop;                 //< ask the background thread to exit
+  aes_randstate_t rng;      //< entropy source of the background thread
+  pthread_t thread;         //< background thread refilling the pool
+  pthread_mutex_t lock;     //< protects `head`, `len` and `stop`
+  pthread_cond_t not_empty; //< signalled when a perturbation was added
+  pthread_cond_t refill;    //< signalled when `len ≤ low` or on `stop`
+} dgsl_rot_mp_pool_t;
+
 
 typedef struct _dgsl_mp_t{
   fmpz_mat_t B; //< basis matrix
@@ -69,6 +98,22 @@ dgsl_mp_t *dgsl_mp_init(const fmpz_mat_t B, mpfr_t sigma, mpfr_t *c, const dgsl_
 
 dgsl_rot_mp_t *dgsl_rot_mp_init(const long n, const fmpz_poly_t B, mpfr_t sigma, fmpq_poly_t c, const dgsl_alg_t algorithm, const oz_flag_t flags);
 
+/**
+   @brief Initialise a `DGSL_INLATTICE` sampler from previously computed data.
+
+   This skips computing the approximate inverse and the square root, which dominate
+   `dgsl_rot_mp_init()`, and is used to restore a sampler from disk.
+
+   @param n          dimension
+   @param B          basis (copied)
+   @param sigma      Gaussian width parameter as stored in `self->sigma` (copied)
+   @param B_inv      approximate inverse of `B` as stored in `self->B_inv` (copied)
+   @param sigma_sqrt square root as stored in `self->sigma_sqrt` (copied)
+*/
+
+dgsl_rot_mp_t *dgsl_rot_mp_init_inlattice(const long n, const fmpz_poly_t B, mpfr_t sigma,
+                                          const fmpq_poly_t B_inv, const fmpq_poly_t sigma_sqrt);
+
 /**
    @brief Sample a fresh element from $D_{L,σ}$.
 */
@@ -77,6 +122,8 @@ int dgsl_mp_call_inlattice(fmpz *rop,  const dgsl_mp_t *self, aes_randstate_t st
 
 /**
    @brief Sample a fresh element from $D_{L,σ}$ using the GPV sampler.
+
+   @note Not thread-safe, this uses scratch space in `self`.
 */
 
 int dgsl_rot_mp_call_gpv_inlattice(fmpz_poly_t rop,  const dgsl_rot_mp_t *self, aes_randstate_t state);
@@ -111,6 +158,42 @@ int dgsl_rot_mp_call_plus_fmpz_poly(fmpz_poly_t rop, const dgsl_rot_mp_t *self,
 
 int dgsl_rot_mp_call_recenter_fmpq_poly(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpq_poly_t c, aes_randstate_t state);
 
+/**
+   @brief Start a pool of perturbations for `self` refilled by a background thread.
+
+   @param self   `DGSL_INLATTICE` sampler, must outlive the pool
+   @param size   maximum number of perturbations kept
+   @param low    refill up to `size` once no more than `low` perturbations are left, `low < size`
+   @param state  entropy source, used to seed the background thread's own stream
+*/
+
+dgsl_rot_mp_pool_t *dgsl_rot_mp_pool_init(const dgsl_rot_mp_t *self, const size_t size, const size_t low,
+                                          aes_randstate_t state);
+
+/**
+   @brief Stop the background thread and free the pool.
+*/
+
+void dgsl_rot_mp_pool_clear(dgsl_rot_mp_pool_t *pool);
+
+/**
+   @brief As `dgsl_rot_mp_call_plus_fmpz_poly()` but take the perturbation from `pool`.
+
+   Blocks if `pool` is empty. `state` is only used for rounding.
+*/
+
+int dgsl_rot_mp_call_plus_fmpz_poly_pool(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpz_poly_t c,
+                                         dgsl_rot_mp_pool_t *pool, aes_randstate_t state);
+
+/**
+   @brief As `dgsl_rot_mp_call_recenter_fmpq_poly()` but take the perturbation from `pool`.
+
+   Blocks if `pool` is empty. `state` is only used for rounding.
+*/
+
+int dgsl_rot_mp_call_recenter_fmpq_poly_pool(fmpz_poly_t rop, const dgsl_rot_mp_t *self, const fmpq_poly_t c,
+                                             dgsl_rot_mp_pool_t *pool, aes_randstate_t state);
+
 /**
    Return a fresh sample when B is the identity
 
@@ -187,6 +270,19 @@ void _dgsl_rot_mp_sqrt_sigma_2(fmpq_poly_t rop, const fmpz_poly_t g, const mpfr_
 
 void fmpz_poly_disc_gauss_rounding(fmpz_poly_t rop, const fmpq_poly_t x, const mpfr_t r_f, aes_randstate_t randstate);
 
+/**
+   @brief As `fmpz_poly_disc_gauss_rounding()` but with centres `x/2^k`.
+*/
+
+void fmpz_poly_disc_gauss_rounding_2exp(fmpz_poly_t rop, const fmpz_poly_t x, const mp_bitcnt_t k,
+                                        const mpfr_t r_f, aes_randstate_t randstate);
+
 void fmpq_poly_sample_D1(fmpq_poly_t f, const int n, const mpfr_prec_t prec, aes_randstate_t state);
 
+/**
+   @brief As `fmpq_poly_sample_D1()` but return `f` such that `f/2^prec` is the sample.
+*/
+
+void fmpz_poly_sample_D1_2exp(fmpz_poly_t f, const int n, const mpfr_prec_t prec, aes_randstate_t state);
+
 #endif
@@ -0,0 +1,145 @@
+#include "gghlite.h"
+#include "gghlite-internals.h"
+
+void
+gghlite_enc_acc_init(gghlite_enc_acc_t op, const gghlite_params_t self)
+{
+    assert(!fmpz_is_zero(self->q));
+    op->n = self->n;
+    op->coeffs = _fmpz_vec_init(op->n);
+    fmpz_init(op->bound);
+    op->max_bits = 2*fmpz_sizeinbase(self->q, 2) + GGHLITE_ENC_ACC_HEADROOM;
+}
+
+void
+gghlite_enc_acc_clear(gghlite_enc_acc_t op)
+{
+    _fmpz_vec_clear(op->coeffs, op->n);
+    fmpz_clear(op->bound);
+}
+
+void
+gghlite_enc_acc_zero(gghlite_enc_acc_t op)
+{
+    _fmpz_vec_zero(op->coeffs, op->n);
+    fmpz_zero(op->bound);
+}
+
+void
+gghlite_enc_acc_reduce(gghlite_enc_acc_t acc, const gghlite_params_t self)
+{
+    const size_t n = acc->n;
+    const int num_threads = self->ntt->num_threads;
+#pragma omp parallel for num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD) schedule(static)
+    for (size_t i = 0; i < n; i++)
+        fmpz_mod(acc->coeffs + i, acc->coeffs + i, self->q);
+    if (fmpz_cmp(acc->bound, self->q) >= 0)
+        fmpz_sub_ui(acc->bound, self->q, 1);
+}
+
+/**
+   Make room for adding `delta` to `acc->bound`, i.e. reduce if the new bound would be too big.
+*/
+
+static void
+_gghlite_enc_acc_grow(gghlite_enc_acc_t acc, const gghlite_params_t self, const fmpz_t delta)
+{
+    fmpz_add(acc->bound, acc->bound, delta);
+    if (fmpz_sizeinbase(acc->bound, 2) > acc->max_bits) {
+        fmpz_sub(acc->bound, acc->bound, delta);
+        gghlite_enc_acc_reduce(acc, self);
+        fmpz_add(acc->bound, acc->bound, delta);
+    }
+}
+
+void
+gghlite_enc_acc_add(gghlite_enc_acc_t acc, const gghlite_params_t self, const gghlite_enc_t f)
+{
+    const size_t n = acc->n;
+    fmpz_t delta;
+    fmpz_init(delta);
+    fmpz_sub_ui(delta, self->q, 1);
+    _gghlite_enc_acc_grow(acc, self, delta);
+    fmpz_clear(delta);
+
+    const slong len = fmpz_mod_poly_length(f);
+    const int num_threads = self->ntt->num_threads;
+#pragma omp parallel for num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD) schedule(static)
+    for (slong i = 0; i < len; i++)
+        fmpz_add(acc->coeffs + i, acc->coeffs + i, f->coeffs + i);
+}
+
+void
+gghlite_enc_acc_sub(gghlite_enc_acc_t acc, const gghlite_params_t self, const gghlite_enc_t f)
+{
+    const size_t n = acc->n;
+    fmpz_t delta;
+    fmpz_init(delta);
+    fmpz_sub_ui(delta, self->q, 1);
+    _gghlite_enc_acc_grow(acc, self, delta);
+    fmpz_clear(delta);
+
+    const slong len = fmpz_mod_poly_length(f);
+    const int num_threads = self->ntt->num_threads;
+#pragma omp parallel for num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD) schedule(static)
+    for (slong i = 0; i < len; i++)
+        fmpz_sub(acc->coeffs + i, acc->coeffs + i, f->coeffs + i);
+}
+
+static void
+_gghlite_enc_acc_addmul(gghlite_enc_acc_t acc, const gghlite_params_t self,
+                        const gghlite_enc_t f, const gghlite_enc_t g, const int negate)
+{
+    const size_t n = acc->n;
+    fmpz_t delta;
+    fmpz_init(delta);
+    fmpz_sub_ui(delta, self->q, 1);
+    fmpz_mul(delta, delta, delta);
+    _gghlite_enc_acc_grow(acc, self, delta);
+    fmpz_clear(delta);
+
+    const slong len = FLINT_MIN(fmpz_mod_poly_length(f), fmpz_mod_poly_length(g));
+    const int num_threads = self->ntt->num_threads;
+#pragma omp parallel for num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD) schedule(static)
+    for (slong i = 0; i < len; i++) {
+        if (negate)
+            fmpz_submul(acc->coeffs + i, f->coeffs + i, g->coeffs + i);
+        else
+            fmpz_addmul(acc->coeffs + i, f->coeffs + i, g->coeffs + i);
+    }
+}
+
+void
+gghlite_enc_acc_addmul(gghlite_enc_acc_t acc, const gghlite_params_t self,
+                       const gghlite_enc_t f, const gghlite_enc_t g)
+{
+    _gghlite_enc_acc_addmul(acc, self, f, g, 0);
+}
+
+void
+gghlite_enc_acc_submul(gghlite_enc_acc_t acc, const gghlite_params_t self,
+                       const gghlite_enc_t f, const gghlite_enc_t g)
+{
+    _gghlite_enc_acc_addmul(acc, self, f, g, 1);
+}
+
+void
+gghlite_enc_set_gghlite_enc_acc(gghlite_enc_t rop, const gghlite_params_t self, const gghlite_enc_acc_t acc)
+{
+    const size_t n = acc->n;
+    fmpz_mod_poly_realloc(rop, n);
+    const int num_threads = self->ntt->num_threads;
+#pragma omp parallel for num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD) schedule(static)
+    for (size_t i = 0; i < n; i++)
+        fmpz_mod(rop->coeffs + i, acc->coeffs + i, self->q);
+    rop->length = n;
+}
+
+int
+gghlite_enc_acc_check_bound(const gghlite_enc_acc_t acc)
+{
+    for (size_t i = 0; i < acc->n; i++)
+        if (fmpz_cmpabs(acc->coeffs + i, acc->bound) > 0)
+            return 0;
+    return 1;
+}
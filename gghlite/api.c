@@ -1,5 +1,6 @@
 #include <stdarg.h>
 #include <stdio.h>
+#include <omp.h>
 #include "gghlite.h"
 #include "gghlite-internals.h"
 
@@ -10,6 +11,27 @@ gghlite_enc_init(gghlite_enc_t op, const gghlite_params_t self)
     fmpz_mod_poly_init2(op, self->q, self->n);
 }
 
+static void
+_gghlite_enc_raise(gghlite_enc_t rop, const gghlite_sk_t self, const size_t k, int *group)
+{
+    if(k == 0)
+        return;
+
+    if(!gghlite_sk_is_symmetric(self) && (k>1))
+        ggh_die("Raising to higher levels than 1 not supported. Instead, multiply by the right combination of y_i.");
+
+    if(gghlite_sk_is_symmetric(self)) {
+        for (unsigned int r = 0; r < self->params->gamma; r++) {
+            if (group[r]) { // divide by z^k, there is only one mask
+                _gghlite_sk_mul_z_inv_pow(rop, self, k);
+                break;
+            }
+        }
+    } else {
+        _gghlite_sk_mul_z_inv_group(rop, self, group);
+    }
+}
+
 void
 gghlite_enc_set_gghlite_clr(gghlite_enc_t rop, const gghlite_sk_t self,
                             const gghlite_clr_t f, const size_t k, int *group,
@@ -20,74 +42,316 @@ gghlite_enc_set_gghlite_clr(gghlite_enc_t rop, const gghlite_sk_t self,
     const oz_flag_t flags = (self->params->flags & GGHLITE_FLAGS_VERBOSE) ? OZ_VERBOSE : 0;
     _fmpz_poly_oz_rem_small_iter(t_o, f, self->g, self->params->n, self->g_inv, prec, flags);
 
-    if (rerand)
+    if (rerand && self->D_g_pool)
+        dgsl_rot_mp_call_plus_fmpz_poly_pool(t_o, self->D_g, t_o, self->D_g_pool, self->rng);
+    else if (rerand)
         dgsl_rot_mp_call_plus_fmpz_poly(t_o, self->D_g, t_o, self->rng);
 
     // encode at level zero
-    fmpz_mod_poly_oz_ntt_enc_fmpz_poly(rop, t_o, self->params->ntt);
+    fmpz_mod_poly_oz_ntt_enc_fmpz_poly_ws(rop, t_o, self->params->ntt, self->ntt_ws);
 
     fmpz_poly_clear(t_o);
 
     // encode at level k
-    if(k > 0) {
-        if(!gghlite_sk_is_symmetric(self) && (k>1))
-            ggh_die("Raising to higher levels than 1 not supported. Instead, multiply by the right combination of y_i.");
+    _gghlite_enc_raise(rop, self, k, group);
+}
 
-        for (unsigned int r = 0; r < self->params->gamma; r++) {
-            if (group[r]) {
-                if(gghlite_sk_is_symmetric(self)) {
-                    for(size_t j=0; j<k; j++) // divide by z_i^k
-                        fmpz_mod_poly_oz_ntt_mul(rop, rop, self->z_inv[r], self->params->n);
-                    break;
-                } else {
-                    fmpz_mod_poly_oz_ntt_mul(rop, rop, self->z_inv[r], self->params->n);
-                }
+void
+gghlite_enc_set_gghlite_clr_many(gghlite_enc_t *rop, const gghlite_sk_t self,
+                                 const gghlite_clr_t *f, const size_t len, const size_t k, int **group,
+                                 const int rerand)
+{
+    if(!gghlite_sk_is_symmetric(self) && (k>1))
+        ggh_die("Raising to higher levels than 1 not supported. Instead, multiply by the right combination of y_i.");
+
+    const mp_bitcnt_t prec = (self->params->n/4 < 8192) ? 8192 : self->params->n/4;
+
+    /* the powers 2^(jb) mod g only depend on g, so compute them once for the whole batch */
+    fmpz_poly_oz_rem_split_t split;
+    fmpz_poly_oz_rem_split_init(split, self->g, self->params->n, self->g_inv, prec, omp_get_max_threads());
+
+    size_t nbytes = 0;
+    unsigned char *seed = (rerand) ? random_aes(self->rng, 128, &nbytes) : NULL;
+
+#pragma omp parallel
+    {
+        fmpz_poly_t t_o; fmpz_poly_init(t_o);
+        fmpz_mod_poly_oz_ntt_ws_t ws;
+        fmpz_mod_poly_oz_ntt_ws_init(ws, self->params->ntt);
+
+#pragma omp for schedule(dynamic)
+        for(size_t i=0; i<len; i++) {
+            _fmpz_poly_oz_rem_small_iter_split(t_o, f[i], self->g, self->params->n, self->g_inv, split, 0);
+
+            if (rerand) {
+                aes_randstate_t stream;
+                _gghlite_aes_stream_init(stream, seed, nbytes, i);
+                dgsl_rot_mp_call_plus_fmpz_poly(t_o, self->D_g, t_o, stream);
+                aes_randclear(stream);
+            }
+
+            // encode at level zero
+            fmpz_mod_poly_oz_ntt_enc_fmpz_poly_ws(rop[i], t_o, self->params->ntt, ws);
+
+            // encode at level k
+            _gghlite_enc_raise(rop[i], self, k, group[i]);
+        }
+
+        fmpz_mod_poly_oz_ntt_ws_clear(ws);
+        fmpz_poly_clear(t_o);
+    }
+
+    free(seed);
+    fmpz_poly_oz_rem_split_clear(split);
+}
+
+void
+gghlite_enc_mul_many(gghlite_enc_t rop, const gghlite_params_t self,
+                     const gghlite_enc_t *ops, const size_t len)
+{
+    assert(len > 0);
+    const size_t n = self->n;
+    const fmpz *q = self->q;
+    const mp_bitcnt_t max_bits = GGHLITE_ENC_MUL_MANY_FACTORS*fmpz_bits(q);
+    fmpz_t zero;
+    fmpz_init(zero);
+    fmpz_mod_poly_realloc(rop, n);
+
+    const int num_threads = self->ntt->num_threads;
+#pragma omp parallel num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+    {
+        fmpz_t acc;
+        fmpz_init2(acc, (GGHLITE_ENC_MUL_MANY_FACTORS + 1)*fmpz_size(q) + 1);
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < n; i++) {
+            fmpz_set(acc, _gghlite_enc_coeff(ops[0], i, zero));
+            /* let the product grow to max_bits, one reduction replaces several */
+            for (size_t j = 1; j < len && !fmpz_is_zero(acc); j++) {
+                fmpz_mul(acc, acc, _gghlite_enc_coeff(ops[j], i, zero));
+                if (fmpz_bits(acc) > max_bits)
+                    fmpz_mod(acc, acc, q);
             }
+            fmpz_mod(acc, acc, q);
+            fmpz_swap(rop->coeffs + i, acc);
         }
+        fmpz_clear(acc);
+    }
+    rop->length = n;
+    fmpz_clear(zero);
+}
+
+void
+gghlite_enc_inner_product(gghlite_enc_t rop, const gghlite_params_t self,
+                          const gghlite_enc_t *a, const gghlite_enc_t *b, const size_t len)
+{
+    const size_t n = self->n;
+    const fmpz *q = self->q;
+    fmpz_t zero;
+    fmpz_init(zero);
+    fmpz_mod_poly_realloc(rop, n);
+
+    const int num_threads = self->ntt->num_threads;
+#pragma omp parallel num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+    {
+        fmpz_t acc;
+        fmpz_init(acc);
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < n; i++) {
+            fmpz_zero(acc);
+            /* |acc| < len·q^2, so we only reduce once */
+            for (size_t j = 0; j < len; j++)
+                fmpz_addmul(acc, _gghlite_enc_coeff(a[j], i, zero), _gghlite_enc_coeff(b[j], i, zero));
+            fmpz_mod(acc, acc, q);
+            fmpz_swap(rop->coeffs + i, acc);
+        }
+        fmpz_clear(acc);
+    }
+    rop->length = n;
+    fmpz_clear(zero);
+}
+
+void
+gghlite_enc_ws_init(gghlite_enc_ws_t ws, const gghlite_params_t self)
+{
+    gghlite_enc_init(ws->t, self);
+    fmpz_init2(ws->c, fmpz_size(self->q));
+    fmpz_init2(ws->acc, 2*fmpz_size(self->q) + 1);
+    fmpz_mod_poly_oz_ntt_ws_init(ws->ntt, self->ntt);
+}
+
+void
+gghlite_enc_ws_clear(gghlite_enc_ws_t ws)
+{
+    fmpz_mod_poly_oz_ntt_ws_clear(ws->ntt);
+    fmpz_clear(ws->acc);
+    fmpz_clear(ws->c);
+    gghlite_enc_clear(ws->t);
+}
+
+/**
+   Return 1 if the centred representative of `t` has 2-norm at most $q^{1-ξ}$.
+
+   We bail out on the first coefficient which is too big on its own or which pushes the running
+   squared norm over the bound.
+*/
+
+static int
+_gghlite_enc_raw_is_small(const gghlite_params_t self, const gghlite_enc_t t, gghlite_enc_ws_t ws)
+{
+    const fmpz *q = self->q;
+    fmpz_zero(ws->acc);
+    for (slong i = 0; i < fmpz_mod_poly_length(t); i++) {
+        /* centre, i.e. c ∈ (-q/2, q/2] */
+        fmpz_sub(ws->c, q, t->coeffs + i);
+        if (fmpz_cmp(ws->c, t->coeffs + i) >= 0)
+            fmpz_set(ws->c, t->coeffs + i);
+        if (fmpz_cmpabs(ws->c, self->zt_bound) > 0)
+            return 0;
+        fmpz_addmul(ws->acc, ws->c, ws->c);
+        if (fmpz_cmp(ws->acc, self->zt_bound_sq) > 0)
+            return 0;
     }
+    return 1;
+}
+
+int
+gghlite_enc_is_zero_ws(const gghlite_params_t self, const gghlite_enc_t op, gghlite_enc_ws_t ws)
+{
+    fmpz_mod_poly_oz_ntt_mul_ws(ws->t, self->pzt, op, self->ntt, ws->ntt);
+    fmpz_mod_poly_oz_ntt_dec_ws(ws->t, ws->t, self->ntt, ws->ntt);
+    return _gghlite_enc_raw_is_small(self, ws->t, ws);
 }
 
 int
 gghlite_enc_is_zero(const gghlite_params_t self, const fmpz_mod_poly_t op)
 {
-    gghlite_clr_t t;
-    mpfr_t norm, bound;
+    gghlite_enc_ws_t ws;
     int r;
 
-    gghlite_clr_init(t);
-    _gghlite_enc_extract_raw(t, self, op);
+    gghlite_enc_ws_init(ws, self);
+    r = gghlite_enc_is_zero_ws(self, op, ws);
+    gghlite_enc_ws_clear(ws);
+    return r;
+}
 
-    mpfr_init2(norm, _gghlite_prec(self));
-    mpfr_init2(bound, _gghlite_prec(self));
-    fmpz_poly_2norm_mpfr(norm, t, MPFR_RNDN);
+/* as _gghlite_enc_raw_is_small() on limbs, `scratch` holds at least 5L+1 limbs */
 
-    {
-        /* Set bound = q */
-        mpz_t q_z;
-        mpz_init(q_z);
-        fmpz_get_mpz(q_z, self->q);
-        mpfr_set_z(bound, q_z, MPFR_RNDN);
-        mpz_clear(q_z);
+static int
+_gghlite_enc_limb_is_small(const gghlite_params_map_t self, const fmpz_mod_poly_oz_limb_t t, mp_limb_t *scratch)
+{
+    const size_t L = self->q->L;
+    mp_limb_t *acc = scratch;       /* 2L+1 limbs */
+    mp_limb_t *sq  = acc + 2*L + 1; /* 2L limbs */
+    mp_limb_t *d   = sq + 2*L;      /* L limbs */
+
+    mpn_zero(acc, 2*L + 1);
+    for (size_t i = 0; i < t->n; i++) {
+        /* centre, i.e. c ∈ (-q/2, q/2] */
+        const mp_limb_t *c = t->coeffs + i*L;
+        mpn_sub_n(d, self->q->q, c, L);
+        if (mpn_cmp(d, c, L) < 0)
+            c = d;
+        if (mpn_cmp(c, self->zt_bound, L) > 0)
+            return 0;
+        mpn_sqr(sq, c, L);
+        acc[2*L] += mpn_add_n(acc, acc, sq, 2*L);
+        if (acc[2*L] || mpn_cmp(acc, self->zt_bound_sq, 2*L) > 0)
+            return 0;
     }
+    return 1;
+}
+
+int
+gghlite_enc_is_zero_mapped(const gghlite_params_map_t self, const fmpz_mod_poly_oz_limb_t op)
+{
+    assert(op->n == (size_t)self->n);
+    assert(op->L == self->q->L);
+
+    const size_t L = self->q->L;
+    mp_limb_t *coeffs = (mp_limb_t *)calloc(self->n*L + 5*L + 1, sizeof(mp_limb_t));
+    fmpz_mod_poly_oz_limb_t t;
+    fmpz_mod_poly_oz_limb_view(t, coeffs, self->n, L);
 
+    fmpz_mod_poly_oz_limb_mul(t, self->pzt, op, self->q);
+    fmpz_mod_poly_oz_limb_ntt_gs(t, self->phi_inv_br, self->n_inv, self->q);
+    const int r = _gghlite_enc_limb_is_small(self, t, coeffs + self->n*L);
+    free(coeffs);
+    return r;
+}
+
+void
+gghlite_enc_is_zero_batch(int *results, const gghlite_params_t self,
+                          const gghlite_enc_t *ops, const size_t count)
+{
+    const int num_threads = self->ntt->num_threads;
+#pragma omp parallel num_threads(num_threads) if(count > 1)
     {
-        /* compute q^{1-xi} */
-        mpfr_t ex;
-        mpfr_init2(ex, _gghlite_prec(self));
-        mpfr_set_ui(ex, 1, MPFR_RNDN);
-        mpfr_sub(ex, ex, self->xi, MPFR_RNDN);
-        mpfr_pow(bound, bound, ex, MPFR_RNDN);
-        mpfr_clear(ex);
+        gghlite_enc_ws_t ws;
+        gghlite_enc_ws_init(ws, self);
+#pragma omp for schedule(dynamic)
+        for (size_t i = 0; i < count; i++)
+            results[i] = gghlite_enc_is_zero_ws(self, ops[i], ws);
+        gghlite_enc_ws_clear(ws);
     }
+}
+
+void
+gghlite_enc_rns_init(gghlite_enc_rns_t op, const gghlite_params_t self)
+{
+    assert(self->flags & GGHLITE_FLAGS_RNS);
+    fmpz_mod_poly_oz_rns_init(op, self->rns);
+}
 
-    r = mpfr_cmp(norm, bound);
+void
+gghlite_enc_rns_set_gghlite_enc(gghlite_enc_rns_t rop, const gghlite_params_t self,
+                                const gghlite_enc_t op)
+{
+    fmpz_mod_poly_oz_rns_set_fmpz_mod_poly(rop, op, self->rns);
+}
 
-    mpfr_clear(bound);
-    mpfr_clear(norm);
-    gghlite_clr_clear(t);
+void
+gghlite_enc_set_gghlite_enc_rns(gghlite_enc_t rop, const gghlite_params_t self,
+                                const gghlite_enc_rns_t op)
+{
+    fmpz_mod_poly_oz_rns_get_fmpz_mod_poly(rop, op, self->rns);
+}
+
+void
+gghlite_enc_limb_init(gghlite_enc_limb_t op, const gghlite_params_t self)
+{
+    assert(self->q_limbs->L);
+    fmpz_mod_poly_oz_limb_init(op, self->n, self->q_limbs);
+}
+
+void
+gghlite_enc_limb_set_gghlite_enc(gghlite_enc_limb_t rop, const gghlite_params_t self,
+                                 const gghlite_enc_t op)
+{
+    (void) self;
+    fmpz_mod_poly_oz_limb_set_fmpz_mod_poly(rop, op);
+}
+
+void
+gghlite_enc_set_gghlite_enc_limb(gghlite_enc_t rop, const gghlite_params_t self,
+                                 const gghlite_enc_limb_t op)
+{
+    (void) self;
+    fmpz_mod_poly_oz_limb_get_fmpz_mod_poly(rop, op);
+}
+
+int
+gghlite_enc_rns_is_zero(const gghlite_params_t self, const gghlite_enc_rns_t op)
+{
+    gghlite_enc_rns_t t;
+    gghlite_enc_ws_t ws;
+    int r;
 
-    if (r <= 0)
-        return 1;
-    else
-        return 0;
+    gghlite_enc_rns_init(t, self);
+    gghlite_enc_ws_init(ws, self);
+    fmpz_mod_poly_oz_rns_mul(t, self->pzt_rns, op, self->rns);
+    fmpz_mod_poly_oz_rns_dec(ws->t, t, self->rns);
+    r = _gghlite_enc_raw_is_small(self, ws->t, ws);
+    gghlite_enc_ws_clear(ws);
+    gghlite_enc_rns_clear(t);
+    return r;
 }
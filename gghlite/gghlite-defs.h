@@ -27,6 +27,85 @@ typedef fmpz_poly_t     gghlite_clr_t;
 
 typedef fmpz_mod_poly_t gghlite_enc_t;
 
+/**
+   Encodings can also be represented as residues modulo each prime $p_i$ dividing $q$ if $q$ was
+   chosen with `GGHLITE_FLAGS_RNS`. This makes multiplications and additions word operations.
+**/
+
+typedef fmpz_mod_poly_oz_rns_t gghlite_enc_rns_t;
+
+/**
+   Encodings can also be stored in one contiguous array of $n·L$ limbs where $L$ is the number of
+   limbs of $q$. This avoids one heap allocation per coefficient and makes memory use predictable.
+**/
+
+typedef fmpz_mod_poly_oz_limb_t gghlite_enc_limb_t;
+
+/**
+   @brief Scratch space for zero-testing encodings.
+
+   Zero-testing with a workspace does not allocate memory once the workspace was used.
+*/
+
+struct _gghlite_enc_ws_struct {
+    gghlite_enc_t t;                  //!< $p_{zt}·f$ and its inverse NTT
+    fmpz_t c;                         //!< centred coefficient
+    fmpz_t acc;                       //!< running squared norm
+    fmpz_mod_poly_oz_ntt_ws_t ntt;    //!< workspace for the product with $p_{zt}$ and the inverse NTT
+};
+
+/**
+   @brief Scratch space for zero-testing encodings.
+
+   @see _gghlite_enc_ws_struct
+*/
+
+typedef struct _gghlite_enc_ws_struct gghlite_enc_ws_t[1];
+
+/**
+   @brief Headroom in bits above $2\log q$ before an accumulator is reduced.
+*/
+
+#define GGHLITE_ENC_ACC_HEADROOM 64
+
+/**
+   @brief Size of a running product in `gghlite_enc_mul_many()`, in multiples of $\log q$ bits,
+   before it is reduced.
+*/
+
+#define GGHLITE_ENC_MUL_MANY_FACTORS 4
+
+/**
+   @brief Version of the binary format written by `gghlite_params_save()` and `gghlite_sk_save()`.
+
+   Bump this whenever the layout changes, loading files with a different version fails.
+*/
+
+#define GGHLITE_IO_VERSION 1
+
+/**
+   @brief Unreduced sum of encodings and products of encodings.
+
+   Coefficients are not reduced modulo $q$ after each operation, instead we keep track of a bound
+   $B$ with $|c_i| ≤ B$ for all coefficients $c_i$ and reduce only once $B$ would exceed
+   `max_bits` bits or when converting back to `gghlite_enc_t`.
+*/
+
+struct _gghlite_enc_acc_struct {
+    fmpz *coeffs;          //!< $n$ unreduced coefficients in the NTT domain
+    size_t n;              //!< number of coefficients
+    fmpz_t bound;          //!< bound $B$ on the absolute value of all coefficients
+    mp_bitcnt_t max_bits;  //!< reduce before $B$ exceeds this many bits
+};
+
+/**
+   @brief Unreduced sum of encodings and products of encodings.
+
+   @see _gghlite_enc_acc_struct
+*/
+
+typedef struct _gghlite_enc_acc_struct gghlite_enc_acc_t[1];
+
 
 /**
    @brief Flags controlling GGHLite behaviour
@@ -41,8 +120,29 @@ typedef enum {
     GGHLITE_FLAGS_QUIET      = 0x10, //!< suppress printing
     GGHLITE_FLAGS_GOOD_G_INV = 0x20, /*!< produce an inverse of $g$ with high-precision,
                                        set this if you plan to call gghlite_enc_set_gghlite_clr */
+    GGHLITE_FLAGS_RNS        = 0x40, /*!< pick $q$ as a product of word-sized NTT-friendly primes,
+                                       required for `gghlite_enc_rns_t` */
+    GGHLITE_FLAGS_SPARSE_Q   = 0x80, /*!< pick $q$ as a prime $2^k - c·2n + 1$ with small $c$, which
+                                       products reduce modulo by folding instead of dividing */
 } gghlite_flag_t;
 
+/**
+   @brief Environment variable naming the parameter cache consulted by `gghlite_params_init_gamma()`.
+
+   @see gghlite_params_cache_get()
+*/
+
+#define GGHLITE_PARAMS_CACHE_ENV "GGHLITE_PARAMS_CACHE"
+
+/**
+   @brief Flags which change the parameters picked by `gghlite_params_init_gamma()`.
+
+   Only these are part of the key of a parameter cache entry, the others only affect what is
+   printed or how the secret key is sampled.
+*/
+
+#define GGHLITE_PARAMS_CACHE_FLAGS (GGHLITE_FLAGS_GDDH_HARD | GGHLITE_FLAGS_RNS | GGHLITE_FLAGS_SPARSE_Q)
+
 /**
    Maximum supported multi-linearity level.
 */
@@ -71,6 +171,8 @@ struct _gghlite_params_struct {
     mpfr_t ell_b;      //!< bound $ℓ_b$ on $σ_n(rot(B^(k)))$
     mpfr_t ell_g;      //!< bound $ℓ_g$ on $|g^-1|$
     mpfr_t xi;         //!< fraction $ξ$ of $q$ used for zero-testing
+    fmpz_t zt_bound;    //!< $\lfloor q^{1-ξ} \rfloor$, no coefficient of a zero-tested encoding may exceed this
+    fmpz_t zt_bound_sq; //!< $\lfloor q^{2(1-ξ)} \rfloor$, bound on the squared norm of a zero-tested encoding
     gghlite_enc_t pzt; //!< zero-testing parameter $p_{zt}$
     /* gghlite_enc_t ***x; /\*!< @brief level-$k$ encodings of zero $x_{i,k,j}$ for each source */
     /*                         group $G_i$, level $k$ specified by rerand mask *\/ */
@@ -78,6 +180,9 @@ struct _gghlite_params_struct {
     /* dgsl_rot_mp_t *D_sigma_p; //!< discrete Gaussian distribution $D_{\\ZZ,σ'}$ */
     /* dgsl_rot_mp_t *D_sigma_s; //!< discrete Gaussian distribution $D_{\\ZZ,σ^*}$ */
     fmpz_mod_poly_oz_ntt_precomp_t ntt; //!< pre-computation data for computing in the NTT domain
+    fmpz_mod_poly_oz_rns_precomp_t rns; //!< pre-computation data for RNS encodings (`GGHLITE_FLAGS_RNS` only)
+    gghlite_enc_rns_t pzt_rns;          //!< zero-testing parameter $p_{zt}$ as RNS encoding (`GGHLITE_FLAGS_RNS` only)
+    fmpz_mod_oz_limb_ctx_t q_limbs;     //!< modulus $q$ for limb encodings `gghlite_enc_limb_t`
 };
 
 /**
@@ -88,6 +193,31 @@ struct _gghlite_params_struct {
 
 typedef struct _gghlite_params_struct gghlite_params_t[1];
 
+/**
+   @brief Number of products $∏_{i ∈ S} z_i^{-1}$ over group subsets $S$ an asymmetric secret key keeps.
+*/
+
+#ifndef GGHLITE_Z_CACHE_SIZE
+#define GGHLITE_Z_CACHE_SIZE 16
+#endif
+
+/**
+   @brief Products of inverse masks built on demand by `gghlite_enc_set_gghlite_clr()`.
+
+   Symmetric instances keep all powers $z_0^{-j}$ for $1 ≤ j ≤ κ$, asymmetric instances keep the
+   `GGHLITE_Z_CACHE_SIZE` most recently used products over group subsets of size at least two.
+*/
+
+struct _gghlite_z_cache_struct {
+    gghlite_enc_t *pow;                        //!< $z_0^{-j}$ at index $j-1$, `NULL` until first used
+    size_t words;                              //!< length of a group bitmask in 64-bit words
+    size_t len;                                //!< number of subset products in use
+    uint64_t clock;                            //!< incremented on each use
+    uint64_t used[GGHLITE_Z_CACHE_SIZE];       //!< value of `clock` at the last use of each entry
+    uint64_t *mask[GGHLITE_Z_CACHE_SIZE];      //!< group bitmask of each entry
+    gghlite_enc_t prod[GGHLITE_Z_CACHE_SIZE];  //!< $∏ z_i^{-1}$ over the groups in `mask`
+};
+
 /**
    @brief GGHLite "secret key".
 */
@@ -98,10 +228,13 @@ struct _gghlite_sk_struct {
     gghlite_clr_t g;     //!< a short principal ideal generator for $\\ideal{g}$
     fmpq_poly_t g_inv;   //!< approximate inverse of $g \\in \\Q[x]/(x^n+1)$
     dgsl_rot_mp_t *D_g;  //!< discrete Gaussian distribution $D_{\\ideal{g},σ'}$
+    dgsl_rot_mp_pool_t *D_g_pool; //!< perturbations for `D_g` or `NULL`, cf. `gghlite_sk_set_D_g_pool()`
 
     gghlite_enc_t *z;           //!< masking elements $z_i$
     gghlite_enc_t *z_inv;       //!< inverse of masking element $z_i$
     gghlite_clr_t h;            //!< masking element $h$
+    struct _gghlite_z_cache_struct *z_cache; //!< products of $z_i^{-1}$, cf. `gghlite_enc_set_gghlite_clr()`
+    struct fmpz_mod_poly_oz_ntt_ws_struct *ntt_ws; //!< NTT workspace for encoding, cf. `gghlite_enc_set_gghlite_clr()`
 
     /* gghlite_clr_t *a; //!< an element $a \\bmod \\ideal{g} = 1$ (for each $G_i$) */
     /* gghlite_clr_t ***b;         //!< an element $b \\bmod \\ideal{g} = 0$ */
@@ -122,4 +255,52 @@ struct _gghlite_sk_struct {
 
 typedef struct _gghlite_sk_struct gghlite_sk_t[1];
 
+/**
+   @brief GGHLite `params` mapped read-only into memory, see `gghlite_params_map()`.
+
+   All arrays point into the mapping and are stored as fixed-width limbs, cf. `oz/limb.h`.
+*/
+
+struct _gghlite_params_map_struct {
+    void *base;                   //!< start of the mapping
+    size_t size;                  //!< length of the mapping in bytes
+    long n;                       //!< dimension of the lattice $n$
+    fmpz_mod_oz_limb_ctx_t q;     //!< modulus $q$
+    const mp_limb_t *n_inv;       //!< $n^{-1} \bmod q$
+    const mp_limb_t *zt_bound;    //!< `zt_bound` as $L$ limbs
+    const mp_limb_t *zt_bound_sq; //!< `zt_bound_sq` as $2L$ limbs
+    fmpz_mod_poly_oz_limb_t pzt;        //!< zero-testing parameter $p_{zt}$
+    fmpz_mod_poly_oz_limb_t phi_br;     //!< NTT twiddle factors, cf. `fmpz_mod_poly_oz_ntt_precomp_t`
+    fmpz_mod_poly_oz_limb_t phi_inv_br; //!< inverse NTT twiddle factors, cf. `fmpz_mod_poly_oz_ntt_precomp_t`
+};
+
+/**
+   @brief GGHLite `params` mapped read-only into memory.
+
+   @see _gghlite_params_map_struct
+*/
+
+typedef struct _gghlite_params_map_struct gghlite_params_map_t[1];
+
+/**
+   @brief Array of encodings mapped read-only into memory, see `gghlite_enc_map()`.
+*/
+
+struct _gghlite_enc_map_struct {
+    void *base;                   //!< start of the mapping
+    size_t size;                  //!< length of the mapping in bytes
+    size_t count;                 //!< number of encodings
+    long n;                       //!< dimension of the lattice $n$
+    size_t L;                     //!< limbs per coefficient
+    const mp_limb_t *coeffs;      //!< encoding $i$ at limbs $i·n·L,…,(i+1)·n·L-1$
+};
+
+/**
+   @brief Array of encodings mapped read-only into memory.
+
+   @see _gghlite_enc_map_struct
+*/
+
+typedef struct _gghlite_enc_map_struct gghlite_enc_map_t[1];
+
 #endif /* _DEFS_H_ */
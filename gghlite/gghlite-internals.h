@@ -187,11 +187,90 @@ _gghlite_params_get_q_mpfr(mpfr_t q, const gghlite_params_t self, mpfr_rnd_t rnd
     mpz_clear(qz);
 }
 
+/**
+   @brief Cache zero-testing bounds $\lfloor q^{1-ξ} \rfloor$ and $\lfloor q^{2(1-ξ)} \rfloor$.
+
+   @param self      GGHLite `params` with $q$ and $ξ$ set
+*/
+
+void _gghlite_params_set_zt_bound(gghlite_params_t self);
+
+/**
+   @brief Seed the private randomness `self->rng` of a secret key from `randstate`.
+*/
+
+void _gghlite_sk_init_rng(gghlite_sk_t self, aes_randstate_t randstate);
+
+/**
+   @brief Initialise `state` as the AES stream for index $i$ derived from `seed`.
+
+   Randomness generation must not be shared between threads, so parallel loops draw one common
+   `seed` of `nbytes` bytes from `self->rng` and run iteration $i$ on its own stream, seeded with
+   `seed` followed by $i$ as 8 little-endian bytes. The output then does not depend on the number of
+   threads.
+*/
+
+static inline void
+_gghlite_aes_stream_init(aes_randstate_t state, const unsigned char *seed, const size_t nbytes, const uint64_t i)
+{
+    unsigned char idx[8];
+    for(int j=0; j<8; j++)
+        idx[j] = (i>>(8*j)) & 0xff;
+    aes_randinit_seedn(state, (char *) seed, nbytes, (char *) idx, sizeof(idx));
+}
+
 /**
    @brief Sample $z_i$ and $z_i^{-1}$.
+
+   The $z_i$ are sampled in parallel, each from an AES stream derived from `self->rng` and $i$, so
+   the result does not depend on the number of threads.
+*/
+
+void _gghlite_sk_sample_z(gghlite_sk_t self);
+
+/**
+   @brief Allocate the NTT workspace `self->ntt_ws` once `self->params->ntt` is set up.
+
+   Encoding with `self` reuses this workspace, so like `self->rng` it must not be used by two
+   threads at once.
+*/
+
+void _gghlite_sk_ntt_ws_init(gghlite_sk_t self);
+
+/**
+   @brief Clear the NTT workspace of `self`.
+*/
+
+void _gghlite_sk_ntt_ws_clear(gghlite_sk_t self);
+
+/**
+   @brief Allocate an empty cache of products of $z_i^{-1}$ for `self`.
 */
 
-void _gghlite_sk_sample_z(gghlite_sk_t self, aes_randstate_t randstate);
+void _gghlite_sk_z_cache_init(gghlite_sk_t self);
+
+/**
+   @brief Clear the cache of products of $z_i^{-1}$ of `self`.
+*/
+
+void _gghlite_sk_z_cache_clear(gghlite_sk_t self);
+
+/**
+   @brief Compute $rop = rop · z_0^{-k}$ for a symmetric instance with one multiplication if $k ≤ κ$.
+
+   All powers up to $κ$ are computed on first use.
+*/
+
+void _gghlite_sk_mul_z_inv_pow(gghlite_enc_t rop, const gghlite_sk_t self, const size_t k);
+
+/**
+   @brief Compute $rop = rop · ∏_{i: group[i] ≠ 0} z_i^{-1}$ for an asymmetric instance.
+
+   Products over two or more groups are kept in a small LRU cache, on a hit this takes one
+   multiplication.
+*/
+
+void _gghlite_sk_mul_z_inv_group(gghlite_enc_t rop, const gghlite_sk_t self, const int *group);
 
 void _gghlite_sk_sample_h(gghlite_sk_t self, aes_randstate_t randstate);
 
@@ -309,10 +388,38 @@ double gghlite_log2_eucl_norm(const gghlite_sk_t self, const gghlite_enc_t op,
    @param rop       initialised encoding, return value
    @param self      initialised GGHLite `params`
    @param f         valid encoding at level-$k$
+   @param ws        workspace initialised with `gghlite_enc_ws_init()`
 
    @ingroup internal-encodings
 */
 
-void _gghlite_enc_extract_raw(gghlite_clr_t rop, const gghlite_params_t self, const gghlite_enc_t f);
+void _gghlite_enc_extract_raw(gghlite_clr_t rop, const gghlite_params_t self, const gghlite_enc_t f,
+                              gghlite_enc_ws_t ws);
+
+/**
+   @brief Multiply RNS encoding $f$ by zero-testing parameter $p_{zt}$.
+
+   @param rop       initialised encoding, return value
+   @param self      initialised GGHLite `params` with `GGHLITE_FLAGS_RNS`
+   @param f         valid encoding at level-$k$
+
+   @ingroup internal-encodings
+*/
+
+void _gghlite_enc_rns_extract_raw(gghlite_clr_t rop, const gghlite_params_t self, const gghlite_enc_rns_t f);
+
+/**
+   @brief Return coefficient $i$ of `op` or `zero` if $i$ is beyond its length.
+
+   Encodings may be normalised to fewer than $n$ coefficients, e.g. by `gghlite_enc_add()`.
+
+   @ingroup internal-encodings
+*/
+
+static inline const fmpz *
+_gghlite_enc_coeff(const gghlite_enc_t op, const size_t i, const fmpz *zero)
+{
+    return ((slong)i < fmpz_mod_poly_length(op)) ? op->coeffs + i : zero;
+}
 
 #endif /* _GGHLITE_INTERNALS_H_ */
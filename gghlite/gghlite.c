@@ -17,6 +17,17 @@ gghlite_sk_set_D_g(gghlite_sk_t self)
     self->t_D_g = ggh_walltime(self->t_D_g);
 }
 
+void
+gghlite_sk_set_D_g_pool(gghlite_sk_t self, const size_t size, const size_t low)
+{
+    assert(self->D_g);
+
+    dgsl_rot_mp_pool_clear(self->D_g_pool);
+    self->D_g_pool = NULL;
+    if (size)
+        self->D_g_pool = dgsl_rot_mp_pool_init(self->D_g, size, low, self->rng);
+}
+
 static void
 _gghlite_sk_sample_g(gghlite_sk_t self, aes_randstate_t randstate)
 {
@@ -133,6 +144,47 @@ _gghlite_sk_sample_g(gghlite_sk_t self, aes_randstate_t randstate)
 }
 
 
+/* rop = ∏_{lo ≤ i < hi} z_i by a product tree of depth log(hi-lo), the products on each level are
+   independent and run in parallel */
+
+static void
+_gghlite_sk_z_product(fmpz_mod_poly_t rop, const gghlite_sk_t self, const size_t lo, const size_t hi)
+{
+    assert(lo < hi);
+    const size_t n = self->params->n;
+    const size_t m = (hi - lo + 1)/2;
+
+    fmpz_mod_poly_t *t = (fmpz_mod_poly_t *)calloc(m, sizeof(fmpz_mod_poly_t));
+
+    uint64_t time = ggh_walltime(0);
+#pragma omp parallel for if(m > 1)
+    for(size_t i=0; i<m; i++) {
+        fmpz_mod_poly_init(t[i], self->params->q);
+        assert(!fmpz_mod_poly_is_zero(self->z[lo+2*i]));
+        if (lo + 2*i + 1 < hi) {
+            assert(!fmpz_mod_poly_is_zero(self->z[lo+2*i+1]));
+            fmpz_mod_poly_oz_ntt_mul_ctx(t[i], self->z[lo+2*i], self->z[lo+2*i+1], n, self->params->q_limbs);
+        } else {
+            fmpz_mod_poly_set(t[i], self->z[lo+2*i]);
+        }
+    }
+
+    /* t_i ← t_i · t_{i+s} for i ≡ 0 mod 2s, so no two products touch the same t_i */
+    for(size_t s=1; s<m; s*=2) {
+        timer_printf("\r    Progress: [%lu / %lu] %8.2fs", 2*s, hi - lo, ggh_seconds(ggh_walltime(time)));
+        const size_t pairs = (m + s - 1)/(2*s);
+#pragma omp parallel for if(pairs > 1)
+        for(size_t j=0; j<pairs; j++)
+            fmpz_mod_poly_oz_ntt_mul_ctx(t[2*s*j], t[2*s*j], t[2*s*j+s], n, self->params->q_limbs);
+    }
+    timer_printf("\r    Progress: [%lu / %lu] %8.2fs\n", hi - lo, hi - lo, ggh_seconds(ggh_walltime(time)));
+
+    fmpz_mod_poly_swap(rop, t[0]);
+    for(size_t i=0; i<m; i++)
+        fmpz_mod_poly_clear(t[i]);
+    free(t);
+}
+
 void
 _gghlite_sk_set_pzt(gghlite_sk_t self)
 {
@@ -148,33 +200,29 @@ _gghlite_sk_set_pzt(gghlite_sk_t self)
         fmpz_mod_poly_set(z_kappa, self->z[0]);
         fmpz_mod_poly_oz_ntt_pow_ui(z_kappa, z_kappa, self->params->kappa, self->params->n);
     } else {
-        fmpz_mod_poly_oz_ntt_set_ui(z_kappa, 1, self->params->n);
-        uint64_t t = ggh_walltime(0);
-        for(size_t i=0; i<self->params->gamma; i++) {
-            assert(!fmpz_mod_poly_is_zero(self->z[i]));
-            fmpz_mod_poly_oz_ntt_mul(z_kappa, z_kappa, self->z[i], self->params->n);
-            timer_printf("\r    Progress: [%lu / %lu] %8.2fs", i+1,
-                         self->params->gamma, ggh_seconds(ggh_walltime(t)));
-            fflush(stdout);
-        }
-        timer_printf("\n");
+        _gghlite_sk_z_product(z_kappa, self, 0, self->params->gamma);
     }
 
     fmpz_mod_poly_t g_inv;  fmpz_mod_poly_init(g_inv, self->params->q);
-    fmpz_mod_poly_oz_ntt_enc_fmpz_poly(g_inv, self->g, self->params->ntt);
-    fmpz_mod_poly_oz_ntt_inv(g_inv, g_inv, self->params->n);
+    fmpz_mod_poly_oz_ntt_enc_fmpz_poly_ws(g_inv, self->g, self->params->ntt, self->ntt_ws);
+    fmpz_mod_poly_oz_ntt_inv_ctx(g_inv, g_inv, self->params->n, self->params->q_limbs);
 
     fmpz_mod_poly_t pzt;  fmpz_mod_poly_init(pzt, self->params->q);
-    fmpz_mod_poly_oz_ntt_mul(pzt, z_kappa, g_inv, self->params->n);
+    fmpz_mod_poly_oz_ntt_mul_ctx(pzt, z_kappa, g_inv, self->params->n, self->params->q_limbs);
 
     fmpz_mod_poly_t h;  fmpz_mod_poly_init(h, self->params->q);
-    fmpz_mod_poly_oz_ntt_enc_fmpz_poly(h, self->h, self->params->ntt);
+    fmpz_mod_poly_oz_ntt_enc_fmpz_poly_ws(h, self->h, self->params->ntt, self->ntt_ws);
 
-    fmpz_mod_poly_oz_ntt_mul(pzt, pzt, h, self->params->n);
+    fmpz_mod_poly_oz_ntt_mul_ctx(pzt, pzt, h, self->params->n, self->params->q_limbs);
 
     fmpz_mod_poly_init(self->params->pzt, self->params->q);
     fmpz_mod_poly_set(self->params->pzt, pzt);
 
+    if (self->params->flags & GGHLITE_FLAGS_RNS) {
+        fmpz_mod_poly_oz_rns_init(self->params->pzt_rns, self->params->rns);
+        fmpz_mod_poly_oz_rns_set_fmpz_mod_poly(self->params->pzt_rns, pzt, self->params->rns);
+    }
+
     fmpz_mod_poly_clear(h);
     fmpz_mod_poly_clear(pzt);
     fmpz_mod_poly_clear(z_kappa);
@@ -218,40 +266,240 @@ _gghlite_sk_sample_h(gghlite_sk_t self, aes_randstate_t randstate)
     mpfr_clear(sqrt_q);
 }
 
+/* sample z_i and z_i^{-1} for lo ≤ i < hi */
+
+static void
+_gghlite_sk_sample_z_range(gghlite_sk_t self, const size_t lo, const size_t hi)
+{
+    size_t nbytes;
+    unsigned char *seed = random_aes(self->rng, 128, &nbytes);
+
+    int progress_count_approx = 0;
+    uint64_t t = ggh_walltime(0);
+#pragma omp parallel if(hi - lo > 1)
+    {
+        fmpz_mod_poly_oz_ntt_ws_t ws;
+        fmpz_mod_poly_oz_ntt_ws_init(ws, self->params->ntt);
+#pragma omp for
+        for(size_t i = lo; i < hi; i++) {
+            aes_randstate_t stream;
+            _gghlite_aes_stream_init(stream, seed, nbytes, i);
+
+            fmpz_mod_poly_init(self->z[i], self->params->q);
+            fmpz_mod_poly_randtest_aes(self->z[i], stream, self->params->n);
+            aes_randclear(stream);
+
+            fmpz_mod_poly_oz_ntt_enc_ws(self->z[i], self->z[i], self->params->ntt, ws);
+            fmpz_mod_poly_init(self->z_inv[i], self->params->q);
+            fmpz_mod_poly_oz_ntt_inv_ctx(self->z_inv[i], self->z[i], self->params->n, self->params->q_limbs);
+#pragma omp critical
+            {
+                progress_count_approx++;
+                timer_printf("\r    Computation Progress (Parallel): [%lu / %lu] %8.2fs",
+                             progress_count_approx, hi - lo, ggh_seconds(ggh_walltime(t)));
+            }
+        }
+        fmpz_mod_poly_oz_ntt_ws_clear(ws);
+    }
+    timer_printf("\n");
+    free(seed);
+}
+
 void
-_gghlite_sk_sample_z(gghlite_sk_t self, aes_randstate_t randstate)
+_gghlite_sk_sample_z(gghlite_sk_t self)
 {
     assert(self->params);
     assert(self->params->n);
     assert(fmpz_cmp_ui(self->params->q, 0)>0);
 
     const size_t bound = (gghlite_sk_is_symmetric(self)) ? 1 : self->params->gamma;
-  
-    /* do not parallelize calls to randomness generation! */  
-    uint64_t t_init = ggh_walltime(0);
-    for(size_t i=0; i<bound; i++) {
-        fmpz_mod_poly_init(self->z[i], self->params->q);
-        fmpz_mod_poly_randtest_aes(self->z[i], randstate, self->params->n);
-        timer_printf("\r    Init Progress: [%lu / %lu] %8.2fs", i+1,
-                     bound, ggh_seconds(ggh_walltime(t_init)));
+    _gghlite_sk_sample_z_range(self, 0, bound);
+}
+
+void
+gghlite_sk_add_groups(gghlite_sk_t self, const size_t count)
+{
+    assert(!gghlite_sk_is_symmetric(self));
+    assert(!fmpz_mod_poly_is_zero(self->params->pzt));
+
+    if (count == 0)
+        return;
+
+    const size_t gamma = self->params->gamma;
+    gghlite_enc_t *z_new     = realloc(self->z,     (gamma + count) * sizeof(gghlite_enc_t));
+    if (z_new == NULL)
+        ggh_die("Cannot allocate %zu z_i", gamma + count);
+    self->z = z_new;
+    gghlite_enc_t *z_inv_new = realloc(self->z_inv, (gamma + count) * sizeof(gghlite_enc_t));
+    if (z_inv_new == NULL)
+        ggh_die("Cannot allocate %zu z_i^{-1}", gamma + count);
+    self->z_inv = z_inv_new;
+    self->params->gamma = gamma + count;
+
+    _gghlite_sk_sample_z_range(self, gamma, gamma + count);
+
+    /* p_zt = h · ∏ z_i / g, so only the new masks need to be multiplied in */
+    fmpz_mod_poly_t z;  fmpz_mod_poly_init(z, self->params->q);
+    _gghlite_sk_z_product(z, self, gamma, gamma + count);
+    fmpz_mod_poly_oz_ntt_mul_ctx(self->params->pzt, self->params->pzt, z, self->params->n, self->params->q_limbs);
+    fmpz_mod_poly_clear(z);
+
+    if (self->params->flags & GGHLITE_FLAGS_RNS)
+        fmpz_mod_poly_oz_rns_set_fmpz_mod_poly(self->params->pzt_rns, self->params->pzt, self->params->rns);
+
+    /* group bitmasks got longer */
+    _gghlite_sk_z_cache_clear(self);
+    _gghlite_sk_z_cache_init(self);
+}
+
+void
+_gghlite_sk_ntt_ws_init(gghlite_sk_t self)
+{
+    self->ntt_ws = (struct fmpz_mod_poly_oz_ntt_ws_struct *)calloc(1, sizeof(struct fmpz_mod_poly_oz_ntt_ws_struct));
+    fmpz_mod_poly_oz_ntt_ws_init(self->ntt_ws, self->params->ntt);
+}
+
+void
+_gghlite_sk_ntt_ws_clear(gghlite_sk_t self)
+{
+    if (!self->ntt_ws)
+        return;
+    fmpz_mod_poly_oz_ntt_ws_clear(self->ntt_ws);
+    free(self->ntt_ws);
+    self->ntt_ws = NULL;
+}
+
+void
+_gghlite_sk_z_cache_init(gghlite_sk_t self)
+{
+    self->z_cache = (struct _gghlite_z_cache_struct *)calloc(1, sizeof(struct _gghlite_z_cache_struct));
+    self->z_cache->words = (self->params->gamma + 63)/64;
+}
+
+void
+_gghlite_sk_z_cache_clear(gghlite_sk_t self)
+{
+    struct _gghlite_z_cache_struct *cache = self->z_cache;
+    if (!cache)
+        return;
+    if (cache->pow) {
+        for(size_t j=0; j<self->params->kappa; j++)
+            fmpz_mod_poly_clear(cache->pow[j]);
+        free(cache->pow);
     }
-    timer_printf("\n");
+    for(size_t e=0; e<cache->len; e++) {
+        fmpz_mod_poly_clear(cache->prod[e]);
+        free(cache->mask[e]);
+    }
+    free(cache);
+    self->z_cache = NULL;
+}
 
-    int progress_count_approx = 0;
-    uint64_t t = ggh_walltime(0);
-#pragma omp parallel for
-    for(size_t i = 0; i < bound; i++) {
-        fmpz_mod_poly_oz_ntt_enc(self->z[i], self->z[i], self->params->ntt);
-        fmpz_mod_poly_init(self->z_inv[i], self->params->q);
-        fmpz_mod_poly_oz_ntt_inv(self->z_inv[i], self->z[i], self->params->n);
-#pragma omp critical
+void
+_gghlite_sk_mul_z_inv_pow(gghlite_enc_t rop, const gghlite_sk_t self, size_t k)
+{
+    struct _gghlite_z_cache_struct *cache = self->z_cache;
+    const size_t kappa = self->params->kappa;
+    const size_t n = self->params->n;
+
+#pragma omp critical(gghlite_z_cache)
+    if (!cache->pow) {
+        gghlite_enc_t *pow = (gghlite_enc_t *)calloc(kappa, sizeof(gghlite_enc_t));
+        fmpz_mod_poly_init(pow[0], self->params->q);
+        fmpz_mod_poly_set(pow[0], self->z_inv[0]);
+        for(size_t j=1; j<kappa; j++) {
+            fmpz_mod_poly_init(pow[j], self->params->q);
+            fmpz_mod_poly_oz_ntt_mul_ctx(pow[j], pow[j-1], self->z_inv[0], n, self->params->q_limbs);
+        }
+        cache->pow = pow;
+    }
+
+    for(; k > kappa; k -= kappa)
+        fmpz_mod_poly_oz_ntt_mul_ctx(rop, rop, cache->pow[kappa-1], n, self->params->q_limbs);
+    if (k)
+        fmpz_mod_poly_oz_ntt_mul_ctx(rop, rop, cache->pow[k-1], n, self->params->q_limbs);
+}
+
+void
+_gghlite_sk_mul_z_inv_group(gghlite_enc_t rop, const gghlite_sk_t self, const int *group)
+{
+    struct _gghlite_z_cache_struct *cache = self->z_cache;
+    const size_t gamma = self->params->gamma;
+    const size_t n = self->params->n;
+    const size_t words = cache->words;
+
+    uint64_t *mask = (uint64_t *)calloc(words, sizeof(uint64_t));
+    size_t count = 0, first = 0;
+    for(size_t i=0; i<gamma; i++) {
+        if (group[i]) {
+            if (count++ == 0)
+                first = i;
+            mask[i/64] |= ((uint64_t)1)<<(i%64);
+        }
+    }
+
+    if (count <= 1) {
+        if (count)
+            fmpz_mod_poly_oz_ntt_mul_ctx(rop, rop, self->z_inv[first], n, self->params->q_limbs);
+        free(mask);
+        return;
+    }
+
+    gghlite_enc_t prod;  fmpz_mod_poly_init(prod, self->params->q);
+    int hit = 0;
+#pragma omp critical(gghlite_z_cache)
+    for(size_t e=0; e<cache->len; e++) {
+        if (memcmp(cache->mask[e], mask, words*sizeof(uint64_t)) == 0) {
+            fmpz_mod_poly_set(prod, cache->prod[e]);
+            cache->used[e] = ++cache->clock;
+            hit = 1;
+            break;
+        }
+    }
+
+    if (!hit) {
+        fmpz_mod_poly_set(prod, self->z_inv[first]);
+        for(size_t i=first+1; i<gamma; i++)
+            if (group[i])
+                fmpz_mod_poly_oz_ntt_mul_ctx(prod, prod, self->z_inv[i], n, self->params->q_limbs);
+
+#pragma omp critical(gghlite_z_cache)
         {
-            progress_count_approx++;
-            timer_printf("\r    Computation Progress (Parallel): [%lu / %lu] %8.2fs",
-                         progress_count_approx, bound, ggh_seconds(ggh_walltime(t)));
+            /* another thread may have added the same subset meanwhile */
+            size_t e = 0;
+            while(e < cache->len && memcmp(cache->mask[e], mask, words*sizeof(uint64_t)))
+                e++;
+            if (e == cache->len) {
+                if (cache->len < GGHLITE_Z_CACHE_SIZE) {
+                    cache->len++;
+                    cache->mask[e] = (uint64_t *)malloc(words*sizeof(uint64_t));
+                    fmpz_mod_poly_init(cache->prod[e], self->params->q);
+                } else {
+                    /* evict the least recently used entry */
+                    e = 0;
+                    for(size_t j=1; j<cache->len; j++)
+                        if (cache->used[j] < cache->used[e])
+                            e = j;
+                }
+                memcpy(cache->mask[e], mask, words*sizeof(uint64_t));
+                fmpz_mod_poly_set(cache->prod[e], prod);
+            }
+            cache->used[e] = ++cache->clock;
         }
     }
-    timer_printf("\n");
+
+    fmpz_mod_poly_oz_ntt_mul_ctx(rop, rop, prod, n, self->params->q_limbs);
+    fmpz_mod_poly_clear(prod);
+    free(mask);
+}
+
+void
+_gghlite_sk_init_rng(gghlite_sk_t self, aes_randstate_t randstate)
+{
+    size_t nbytes;
+    unsigned char *buf = random_aes(randstate, 128, &nbytes);
+    aes_randinit_seedn(self->rng, (char *) buf, nbytes, NULL, 0);
+    free(buf);
 }
 
 void
@@ -261,12 +509,7 @@ gghlite_sk_init(gghlite_sk_t self, aes_randstate_t randstate)
     assert(self->params->kappa);
     assert(self->params->gamma);
 
-    {
-        size_t nbytes;
-        unsigned char *buf = random_aes(randstate, 128, &nbytes);
-        aes_randinit_seedn(self->rng, (char *) buf, nbytes, NULL, 0);
-        free(buf);
-    }
+    _gghlite_sk_init_rng(self, randstate);
 
     self->t_coprime = 0;
     self->t_is_prime = 0;
@@ -274,10 +517,18 @@ gghlite_sk_init(gghlite_sk_t self, aes_randstate_t randstate)
 
     self->z     = calloc(self->params->gamma, sizeof(gghlite_enc_t));
     self->z_inv = calloc(self->params->gamma, sizeof(gghlite_enc_t));
+    _gghlite_sk_z_cache_init(self);
+    self->D_g_pool = NULL;
   
     start_timer();
     timer_printf("Starting precomp init...\n");
-    fmpz_mod_poly_oz_ntt_precomp_init(self->params->ntt, self->params->n, self->params->q);
+    if (self->params->flags & GGHLITE_FLAGS_RNS) {
+        fmpz_mod_poly_oz_rns_precomp_init(self->params->rns, self->params->n, self->params->q);
+        fmpz_mod_poly_oz_ntt_precomp_init_rns(self->params->ntt, self->params->rns);
+    } else {
+        fmpz_mod_poly_oz_ntt_precomp_init(self->params->ntt, self->params->n, self->params->q);
+    }
+    _gghlite_sk_ntt_ws_init(self);
     timer_printf("Finished precomp init");
     print_timer();
     timer_printf("\n");
@@ -291,7 +542,7 @@ gghlite_sk_init(gghlite_sk_t self, aes_randstate_t randstate)
   
     start_timer();
     timer_printf("Starting sampling z...\n");
-    _gghlite_sk_sample_z(self, randstate);
+    _gghlite_sk_sample_z(self);
     timer_printf("Finished sampling z");
     print_timer();
     timer_printf("\n");
@@ -338,9 +589,12 @@ gghlite_sk_clear(gghlite_sk_t self, int clear_params)
         fmpz_mod_poly_clear(self->z_inv[i]);
     }
 
+    _gghlite_sk_z_cache_clear(self);
+    _gghlite_sk_ntt_ws_clear(self);
     fmpz_poly_clear(self->h);
     fmpz_poly_clear(self->g);
     fmpq_poly_clear(self->g_inv);
+    dgsl_rot_mp_pool_clear(self->D_g_pool);
     dgsl_rot_mp_clear(self->D_g);
 
     free(self->z);
@@ -447,12 +701,25 @@ _gghlite_dgsl_from_n(const long n, mpfr_t sigma, const oz_flag_t flags)
 /* Compute || [pzt \cdot op]_q ||_\infty */
 void
 _gghlite_enc_extract_raw(gghlite_clr_t rop, const gghlite_params_t self,
-                         const gghlite_enc_t op)
+                         const gghlite_enc_t op, gghlite_enc_ws_t ws)
+{
+    fmpz_mod_poly_oz_ntt_mul_ws(ws->t, self->pzt, op, self->ntt, ws->ntt);
+    fmpz_mod_poly_oz_ntt_dec_ws(ws->t, ws->t, self->ntt, ws->ntt);
+    fmpz_poly_set_fmpz_mod_poly(rop, ws->t);
+}
+
+void
+_gghlite_enc_rns_extract_raw(gghlite_clr_t rop, const gghlite_params_t self,
+                             const gghlite_enc_rns_t op)
 {
-    gghlite_enc_t t;
-    gghlite_enc_init(t, self);
-    fmpz_mod_poly_oz_ntt_mul(t, self->pzt, op, self->n);
-    fmpz_mod_poly_oz_ntt_dec(t, t, self->ntt);
-    fmpz_poly_set_fmpz_mod_poly(rop, t);
-    gghlite_enc_clear(t);
+    gghlite_enc_rns_t t;
+    gghlite_enc_rns_init(t, self);
+    fmpz_mod_poly_oz_rns_mul(t, self->pzt_rns, op, self->rns);
+
+    gghlite_enc_t u;
+    gghlite_enc_init(u, self);
+    fmpz_mod_poly_oz_rns_dec(u, t, self->rns);
+    fmpz_poly_set_fmpz_mod_poly(rop, u);
+    gghlite_enc_clear(u);
+    gghlite_enc_rns_clear(t);
 }
@@ -44,6 +44,9 @@ void gghlite_params_initzero(gghlite_params_t self, size_t lambda, size_t kappa,
 /**
    @brief Generate parameters for GGHLite instance requiring no randomness.
 
+   If the environment variable `GGHLITE_PARAMS_CACHE` names a parameter cache holding an entry for
+   these inputs, the search over $n$ and $q$ is skipped, cf. `gghlite_params_cache_get()`.
+
    @param self        GGHLite `params`, all fields are overwritten
    @param lambda      security parameter $λ > 0$
    @param kappa       multi-linearity parameter $κ > 0$
@@ -100,6 +103,26 @@ void gghlite_sk_init(gghlite_sk_t self, aes_randstate_t randstate);
 void
 gghlite_sk_set_D_g(gghlite_sk_t self);
 
+/**
+   @brief Pre-compute perturbations for re-randomisation in the background.
+
+   Re-randomising encodings in `gghlite_enc_set_gghlite_clr()` then only pays for the
+   centre-dependent part of sampling from `self->D_g`. The pool is seeded from `self->rng`
+   and released by `gghlite_sk_clear()`.
+
+   @param self  GGHLite secret key with `self->D_g` set
+   @param size  number of perturbations to keep, zero disables the pool
+   @param low   refill once no more than `low` perturbations are left, `low < size`
+
+   @note `gghlite_enc_set_gghlite_clr_many()` does not use the pool so that its output does not
+   depend on the number of threads.
+
+   @ingroup params
+*/
+
+void
+gghlite_sk_set_D_g_pool(gghlite_sk_t self, const size_t size, const size_t low);
+
 void gghlite_params_set_D_sigmas(gghlite_params_t params);
 
 /**
@@ -152,6 +175,22 @@ gghlite_jigsaw_init(gghlite_sk_t self, size_t lambda, size_t kappa,
 	gghlite_jigsaw_init_gamma(self, lambda, kappa, kappa, flags, randstate);
 }
 
+/**
+   @brief Add `count` index groups to the asymmetric instance `self`.
+
+   Samples $z_γ,…,z_{γ+count-1}$ and their inverses and multiplies $p_{zt}$ by their product, instead
+   of recomputing it from all $z_i$. Afterwards the top level is the union of the old top level and
+   the new groups, encodings made before remain valid at their level. The number of multiplications
+   is still bounded by $κ$. Shallow copies of `self->params` made before are not updated.
+
+   @param self      initialised asymmetric GGHLite secret key
+   @param count     number of index groups to add
+
+   @ingroup params
+*/
+
+void gghlite_sk_add_groups(gghlite_sk_t self, const size_t count);
+
 
 
 /**
@@ -192,6 +231,178 @@ void gghlite_params_clear(gghlite_params_t self);
 
 void gghlite_sk_clear(gghlite_sk_t self, int clear_params);
 
+/**
+   @brief Write GGHLite `params` to `fp` in a versioned binary format.
+
+   Everything needed to work with `self` is written, including $q$, $p_{zt}$ and the root of unity
+   from which the NTT pre-computation is restored.
+
+   @param fp        stream opened for writing in binary mode
+   @param self      GGHLite `params` as produced by `gghlite_sk_init()`
+   @return 0 on success, -1 if writing failed
+
+   @ingroup params
+*/
+
+int gghlite_params_save(FILE *fp, const gghlite_params_t self);
+
+/**
+   @brief Read GGHLite `params` written by `gghlite_params_save()`.
+
+   @param self      uninitialised GGHLite `params`, clear with `gghlite_params_clear()` on success
+   @param fp        stream opened for reading in binary mode
+   @return 0 on success, -1 if the stream is truncated, malformed or of a different
+           `GGHLITE_IO_VERSION`, in which case nothing needs to be cleared
+
+   @ingroup params
+*/
+
+int gghlite_params_load(gghlite_params_t self, FILE *fp);
+
+/**
+   @brief Look up the parameters for `self` in the parameter cache at `path`.
+
+   Entries are keyed by $(λ, κ, γ)$, the re-randomisation mask and those `flags` in
+   `GGHLITE_PARAMS_CACHE_FLAGS`. On a hit $n$, $\ell$, $q$, $ξ$, $σ$, $\ell_g$, $σ'$ and $σ^*$ are
+   set to what `gghlite_params_init_gamma()` would compute, which skips the search over $n$.
+
+   @param self      GGHLite `params` as produced by `gghlite_params_initzero()` with
+                    `rerand_mask` and `flags` set
+   @param path      cache file as written by `gghlite_params_cache_add()`
+   @return 0 on a hit, -1 if there is no matching entry or the file is missing or malformed
+
+   @ingroup params
+*/
+
+int gghlite_params_cache_get(gghlite_params_t self, const char *path);
+
+/**
+   @brief Add the parameters `self` to the parameter cache at `path`.
+
+   The file is created if it does not exist, nothing is written if it holds an entry for the same
+   key already.
+
+   @param path      cache file
+   @param self      GGHLite `params` as produced by `gghlite_params_init_gamma()`
+   @return 0 on success, -1 if writing failed or `path` is not a parameter cache of this
+           `GGHLITE_IO_VERSION`
+
+   @ingroup params
+*/
+
+int gghlite_params_cache_add(const char *path, const gghlite_params_t self);
+
+/**
+   @brief Write GGHLite secret key to `fp` in a versioned binary format.
+
+   In addition to `self->params` this stores $g$, $g^{-1}$, $h$, $z_i$, $z_i^{-1}$ and the state of
+   $D_g$, so that loading skips all sampling, inversions and square roots.
+
+   @param fp        stream opened for writing in binary mode
+   @param self      initialised GGHLite secret key
+   @return 0 on success, -1 if writing failed
+
+   @ingroup params
+*/
+
+int gghlite_sk_save(FILE *fp, const gghlite_sk_t self);
+
+/**
+   @brief Read GGHLite secret key written by `gghlite_sk_save()`.
+
+   @param self      uninitialised GGHLite secret key, clear with `gghlite_sk_clear()` on success
+   @param fp        stream opened for reading in binary mode
+   @param randstate entropy source to seed the private randomness of `self`
+   @return 0 on success, -1 if the stream is truncated, malformed or of a different
+           `GGHLITE_IO_VERSION`, in which case nothing needs to be cleared
+
+   @ingroup params
+*/
+
+int gghlite_sk_load(gghlite_sk_t self, FILE *fp, aes_randstate_t randstate);
+
+/**
+   @brief Write the public data needed for zero-testing in a layout that can be `mmap`ed.
+
+   The modulus, $n^{-1}$, the zero-testing bounds, $p_{zt}$ and the NTT twiddle factors are written
+   as fixed-width little-endian limb arrays, cf. `oz/limb.h`.
+
+   @param fp        stream opened for writing in binary mode
+   @param self      GGHLite `params` as produced by `gghlite_sk_init()`
+   @return 0 on success, -1 if writing failed
+
+   @ingroup params
+*/
+
+int gghlite_params_save_mapped(FILE *fp, const gghlite_params_t self);
+
+/**
+   @brief Map a file written by `gghlite_params_save_mapped()` read-only into memory.
+
+   Nothing is parsed or copied, processes mapping the same file share the page cache.
+
+   @param self      uninitialised map, release with `gghlite_params_unmap()` on success
+   @param fp        stream of the file which must start at offset 0, it may be closed afterwards
+   @return 0 on success, -1 if the file is malformed, of a different `GGHLITE_IO_VERSION` or if
+           the host does not use 64-bit little-endian limbs
+
+   @ingroup params
+*/
+
+int gghlite_params_map(gghlite_params_map_t self, FILE *fp);
+
+/**
+   @brief Release a map created by `gghlite_params_map()`.
+
+   @ingroup params
+*/
+
+void gghlite_params_unmap(gghlite_params_map_t self);
+
+/**
+   @brief Write `count` encodings in a layout that can be `mmap`ed, cf. `gghlite_params_save_mapped()`.
+
+   @param fp        stream opened for writing in binary mode
+   @param self      initialised GGHLite `params`
+   @param ops       array of `count` encodings
+   @param count     number of encodings
+   @return 0 on success, -1 if writing failed
+
+   @ingroup encodings
+*/
+
+int gghlite_enc_save_mapped(FILE *fp, const gghlite_params_t self, const gghlite_enc_t *ops, const size_t count);
+
+/**
+   @brief Map a file written by `gghlite_enc_save_mapped()` read-only into memory.
+
+   @param self      uninitialised map, release with `gghlite_enc_unmap()` on success
+   @param fp        stream of the file which must start at offset 0, it may be closed afterwards
+   @return 0 on success, -1 otherwise
+
+   @ingroup encodings
+*/
+
+int gghlite_enc_map(gghlite_enc_map_t self, FILE *fp);
+
+/**
+   @brief Release a map created by `gghlite_enc_map()`.
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_unmap(gghlite_enc_map_t self);
+
+/**
+   @brief Let `rop` be a read-only view on the `i`-th encoding in `self`, $i <$ `self->count`.
+
+   @ingroup encodings
+*/
+
+static inline void gghlite_enc_map_get(fmpz_mod_poly_oz_limb_t rop, const gghlite_enc_map_t self, const size_t i) {
+  fmpz_mod_poly_oz_limb_view(rop, self->coeffs + i*self->n*self->L, self->n, self->L);
+}
+
 /* parameter estimation functions */
 double gghlite_params_get_enc(const gghlite_params_t self);
 void gghlite_params_test_kappa_enc_size(size_t lambda, size_t max_kappa, FILE *fp);
@@ -429,6 +640,9 @@ void gghlite_enc_sample(gghlite_enc_t rop, gghlite_params_t self, size_t k, size
 
    @note If `self` is an asymmetric map only, then $k ≤ 1$ is required.
 
+   @note This uses the random state, mask cache and NTT workspace of `self` and must not be called
+   on the same `self` by two threads at once, use `gghlite_enc_set_gghlite_clr_many()` instead.
+
    @ingroup encodings
 */
 
@@ -437,6 +651,34 @@ gghlite_enc_set_gghlite_clr(gghlite_enc_t rop, const gghlite_sk_t self,
                             const gghlite_clr_t f, const size_t k, int *group,
                             const int rerand);
 
+/**
+   @brief Encode $f_i$ at level-$k$ in groups `group[i]` for $0 ≤ i < len$.
+
+   Elements are reduced modulo $\ideal{g}$, re-randomised and transformed in parallel, one
+   element per thread at a time. The powers of two modulo $\ideal{g}$ needed for reducing
+   integers are computed once per call and NTT workspaces once per thread.
+
+   @param rop       array of `len` initialised encodings, return value
+   @param self      initialised GGHLite instance
+   @param f         array of `len` elements in $\ZZ[x]/(x^n+1)$
+   @param len       number of elements
+   @param k         targer level $0 ≤ k ≤ κ$
+   @param group     array of `len` group selectors as in `gghlite_enc_set_gghlite_clr()`
+   @param rerand    flag controlling if re-randomisation is run after raising
+
+   @note Re-randomisation of $f_i$ uses its own AES stream seeded from `self->rng` and $i$, so the
+   output does not depend on the number of threads.
+
+   @note If `self` is an asymmetric map only, then $k ≤ 1$ is required.
+
+   @ingroup encodings
+*/
+
+void
+gghlite_enc_set_gghlite_clr_many(gghlite_enc_t *rop, const gghlite_sk_t self,
+                                 const gghlite_clr_t *f, const size_t len, const size_t k, int **group,
+                                 const int rerand);
+
 /**
    @brief Encode $f$ at level-$0$.
 
@@ -473,7 +715,7 @@ static inline void
 gghlite_enc_mul(gghlite_enc_t h, const gghlite_params_t self,
                 const gghlite_enc_t f, const gghlite_enc_t g)
 {
-    fmpz_mod_poly_oz_ntt_mul(h, f, g, self->n);
+    fmpz_mod_poly_oz_ntt_mul_ctx(h, f, g, self->n, self->q_limbs);
 }
 
 /**
@@ -514,6 +756,150 @@ gghlite_enc_sub(gghlite_enc_t h, const gghlite_params_t self,
     fmpz_mod_poly_sub(h, f, g);
 }
 
+/**
+   @brief Compute $h = \prod_{j} f_j$.
+
+   Coefficients are processed independently and in parallel. Each running product is only reduced
+   once it exceeds `GGHLITE_ENC_MUL_MANY_FACTORS`$·\log q$ bits and $h$ is written once. `rop` may alias any of the `ops`.
+
+   @param rop       initialised encoding, return value
+   @param self      initialised GGHLite `params`
+   @param ops       array of `len` valid encodings
+   @param len       number of factors, $len > 0$
+
+   @ingroup encodings
+*/
+
+void
+gghlite_enc_mul_many(gghlite_enc_t rop, const gghlite_params_t self,
+                     const gghlite_enc_t *ops, const size_t len);
+
+/**
+   @brief Compute $h = \sum_{j} a_j·b_j$.
+
+   Products are accumulated without reduction and each coefficient is reduced modulo $q$ once at
+   the end. `rop` may alias any of the inputs.
+
+   @param rop       initialised encoding, return value
+   @param self      initialised GGHLite `params`
+   @param a         array of `len` valid encodings
+   @param b         array of `len` valid encodings
+   @param len       number of products
+
+   @ingroup encodings
+*/
+
+void
+gghlite_enc_inner_product(gghlite_enc_t rop, const gghlite_params_t self,
+                          const gghlite_enc_t *a, const gghlite_enc_t *b, const size_t len);
+
+/**
+   @brief Initialise accumulator to zero.
+
+   @param op        uninitialised accumulator
+   @param self      initialised GGHLite `params`
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_acc_init(gghlite_enc_acc_t op, const gghlite_params_t self);
+
+/**
+   @brief Clear accumulator.
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_acc_clear(gghlite_enc_acc_t op);
+
+/**
+   @brief Set accumulator to zero.
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_acc_zero(gghlite_enc_acc_t op);
+
+/**
+   @brief Compute $\mbox{acc} = \mbox{acc} + f$ without reducing modulo $q$.
+
+   @param acc       initialised accumulator
+   @param self      initialised GGHLite `params`
+   @param f         valid encoding
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_acc_add(gghlite_enc_acc_t acc, const gghlite_params_t self, const gghlite_enc_t f);
+
+/**
+   @brief Compute $\mbox{acc} = \mbox{acc} - f$ without reducing modulo $q$.
+
+   @param acc       initialised accumulator
+   @param self      initialised GGHLite `params`
+   @param f         valid encoding
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_acc_sub(gghlite_enc_acc_t acc, const gghlite_params_t self, const gghlite_enc_t f);
+
+/**
+   @brief Compute $\mbox{acc} = \mbox{acc} + f·g$ without reducing modulo $q$.
+
+   @param acc       initialised accumulator
+   @param self      initialised GGHLite `params`
+   @param f         valid encoding
+   @param g         valid encoding
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_acc_addmul(gghlite_enc_acc_t acc, const gghlite_params_t self,
+                            const gghlite_enc_t f, const gghlite_enc_t g);
+
+/**
+   @brief Compute $\mbox{acc} = \mbox{acc} - f·g$ without reducing modulo $q$.
+
+   @param acc       initialised accumulator
+   @param self      initialised GGHLite `params`
+   @param f         valid encoding
+   @param g         valid encoding
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_acc_submul(gghlite_enc_acc_t acc, const gghlite_params_t self,
+                            const gghlite_enc_t f, const gghlite_enc_t g);
+
+/**
+   @brief Reduce all coefficients of `acc` modulo $q$.
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_acc_reduce(gghlite_enc_acc_t acc, const gghlite_params_t self);
+
+/**
+   @brief Set `rop` to `acc` reduced modulo $q$, `acc` is left unchanged.
+
+   @param rop       initialised encoding, return value
+   @param self      initialised GGHLite `params`
+   @param acc       initialised accumulator
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_set_gghlite_enc_acc(gghlite_enc_t rop, const gghlite_params_t self, const gghlite_enc_acc_t acc);
+
+/**
+   @brief Return 1 if all coefficients of `acc` are within its tracked bound.
+
+   @ingroup encodings
+*/
+
+int gghlite_enc_acc_check_bound(const gghlite_enc_acc_t acc);
+
 /**
    @brief Return 1 if $f$ is an encoding of zero at level $κ$
 
@@ -526,6 +912,287 @@ gghlite_enc_sub(gghlite_enc_t h, const gghlite_params_t self,
 int
 gghlite_enc_is_zero(const gghlite_params_t self, const gghlite_enc_t op);
 
+/**
+   @brief Initialise workspace for zero-testing.
+
+   @param ws        uninitialised workspace
+   @param self      initialised GGHLite `params`
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_ws_init(gghlite_enc_ws_t ws, const gghlite_params_t self);
+
+/**
+   @brief Clear workspace.
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_ws_clear(gghlite_enc_ws_t ws);
+
+/**
+   @brief Return 1 if $f$ is an encoding of zero at level $κ$ using workspace `ws`.
+
+   The norm is compared against the bound cached in `params` using integer arithmetic only. Each
+   thread must use its own workspace.
+
+   @param self      initialised GGHLite `params`
+   @param op        valid encoding at level-$κ$
+   @param ws        initialised workspace
+
+   @ingroup encodings
+*/
+
+int
+gghlite_enc_is_zero_ws(const gghlite_params_t self, const gghlite_enc_t op, gghlite_enc_ws_t ws);
+
+/**
+   @brief Zero-test `count` encodings in parallel.
+
+   Each thread allocates one workspace and zero-tests whole encodings, i.e. the transforms
+   themselves run serially.
+
+   @param results   array of length `count`, `results[i]` is set to 1 if `ops[i]` encodes zero
+   @param self      initialised GGHLite `params`
+   @param ops       array of `count` valid encodings at level-$κ$
+   @param count     number of encodings
+
+   @ingroup encodings
+*/
+
+void
+gghlite_enc_is_zero_batch(int *results, const gghlite_params_t self,
+                          const gghlite_enc_t *ops, const size_t count);
+
+/**
+   @brief Return 1 if the limb encoding `op` is an encoding of zero at level $κ$.
+
+   This works directly on mapped memory, no encoding or parameter is converted to `fmpz`.
+
+   @param self      mapped GGHLite `params`
+   @param op        view on a valid encoding at level-$κ$, e.g. from `gghlite_enc_map_get()`
+
+   @ingroup encodings
+*/
+
+int
+gghlite_enc_is_zero_mapped(const gghlite_params_map_t self, const fmpz_mod_poly_oz_limb_t op);
+
+/**
+   @brief Initialise RNS encoding to zero.
+
+   @param op   uninitialised RNS encoding
+   @param self initialised GGHLite `params` with `GGHLITE_FLAGS_RNS` set
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_rns_init(gghlite_enc_rns_t op, const gghlite_params_t self);
+
+#define gghlite_enc_rns_clear fmpz_mod_poly_oz_rns_clear
+
+/**
+   @brief Convert encoding to RNS encoding.
+
+   @param rop       initialised RNS encoding, return value
+   @param self      initialised GGHLite `params` with `GGHLITE_FLAGS_RNS` set
+   @param op        valid encoding
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_rns_set_gghlite_enc(gghlite_enc_rns_t rop, const gghlite_params_t self, const gghlite_enc_t op);
+
+/**
+   @brief Convert RNS encoding to encoding.
+
+   @param rop       initialised encoding, return value
+   @param self      initialised GGHLite `params` with `GGHLITE_FLAGS_RNS` set
+   @param op        valid RNS encoding
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_set_gghlite_enc_rns(gghlite_enc_t rop, const gghlite_params_t self, const gghlite_enc_rns_t op);
+
+/**
+   @brief Compute $h = f·g$ for RNS encodings.
+
+   @param h         initialised RNS encoding, return value
+   @param self      initialised GGHLite `params` with `GGHLITE_FLAGS_RNS` set
+   @param f         valid RNS encoding
+   @param g         valid RNS encoding
+
+   @ingroup encodings
+*/
+
+static inline void
+gghlite_enc_rns_mul(gghlite_enc_rns_t h, const gghlite_params_t self,
+                    const gghlite_enc_rns_t f, const gghlite_enc_rns_t g)
+{
+    fmpz_mod_poly_oz_rns_mul(h, f, g, self->rns);
+}
+
+/**
+   @brief Compute $h = f+g$ for RNS encodings.
+
+   @param h         initialised RNS encoding, return value
+   @param self      initialised GGHLite `params` with `GGHLITE_FLAGS_RNS` set
+   @param f         valid RNS encoding
+   @param g         valid RNS encoding
+
+   @ingroup encodings
+*/
+
+static inline void
+gghlite_enc_rns_add(gghlite_enc_rns_t h, const gghlite_params_t self,
+                    const gghlite_enc_rns_t f, const gghlite_enc_rns_t g)
+{
+    fmpz_mod_poly_oz_rns_add(h, f, g, self->rns);
+}
+
+/**
+   @brief Compute $h = f-g$ for RNS encodings.
+
+   @param h         initialised RNS encoding, return value
+   @param self      initialised GGHLite `params` with `GGHLITE_FLAGS_RNS` set
+   @param f         valid RNS encoding
+   @param g         valid RNS encoding
+
+   @ingroup encodings
+*/
+
+static inline void
+gghlite_enc_rns_sub(gghlite_enc_rns_t h, const gghlite_params_t self,
+                    const gghlite_enc_rns_t f, const gghlite_enc_rns_t g)
+{
+    fmpz_mod_poly_oz_rns_sub(h, f, g, self->rns);
+}
+
+/**
+   @brief Return 1 if RNS encoding $f$ is an encoding of zero at level $κ$
+
+   The CRT is only applied here, after multiplying by $p_{zt}$ and leaving the NTT domain.
+
+   @param self      initialised GGHLite `params` with `GGHLITE_FLAGS_RNS` set
+   @param op        valid RNS encoding at level-$κ$
+
+   @ingroup encodings
+*/
+
+int
+gghlite_enc_rns_is_zero(const gghlite_params_t self, const gghlite_enc_rns_t op);
+
+/**
+   @brief Initialise limb encoding to zero.
+
+   @param op   uninitialised limb encoding
+   @param self initialised GGHLite `params`
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_limb_init(gghlite_enc_limb_t op, const gghlite_params_t self);
+
+#define gghlite_enc_limb_clear fmpz_mod_poly_oz_limb_clear
+
+/**
+   @brief Convert encoding to limb encoding.
+
+   @param rop       initialised limb encoding, return value
+   @param self      initialised GGHLite `params`
+   @param op        valid encoding
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_limb_set_gghlite_enc(gghlite_enc_limb_t rop, const gghlite_params_t self, const gghlite_enc_t op);
+
+/**
+   @brief Convert limb encoding to encoding.
+
+   @param rop       initialised encoding, return value
+   @param self      initialised GGHLite `params`
+   @param op        valid limb encoding
+
+   @ingroup encodings
+*/
+
+void gghlite_enc_set_gghlite_enc_limb(gghlite_enc_t rop, const gghlite_params_t self, const gghlite_enc_limb_t op);
+
+/**
+   @brief Compute $h = f·g$ for limb encodings.
+
+   @param h         initialised limb encoding, return value
+   @param self      initialised GGHLite `params`
+   @param f         valid limb encoding
+   @param g         valid limb encoding
+
+   @ingroup encodings
+*/
+
+static inline void
+gghlite_enc_limb_mul(gghlite_enc_limb_t h, const gghlite_params_t self,
+                     const gghlite_enc_limb_t f, const gghlite_enc_limb_t g)
+{
+    fmpz_mod_poly_oz_limb_mul(h, f, g, self->q_limbs);
+}
+
+/**
+   @brief Compute $h = h + f·g$ for limb encodings, reducing once per coefficient.
+
+   @param h         valid limb encoding, return value
+   @param self      initialised GGHLite `params`
+   @param f         valid limb encoding
+   @param g         valid limb encoding
+
+   @ingroup encodings
+*/
+
+static inline void
+gghlite_enc_limb_addmul(gghlite_enc_limb_t h, const gghlite_params_t self,
+                        const gghlite_enc_limb_t f, const gghlite_enc_limb_t g)
+{
+    fmpz_mod_poly_oz_limb_addmul(h, f, g, self->q_limbs);
+}
+
+/**
+   @brief Compute $h = f+g$ for limb encodings.
+
+   @param h         initialised limb encoding, return value
+   @param self      initialised GGHLite `params`
+   @param f         valid limb encoding
+   @param g         valid limb encoding
+
+   @ingroup encodings
+*/
+
+static inline void
+gghlite_enc_limb_add(gghlite_enc_limb_t h, const gghlite_params_t self,
+                     const gghlite_enc_limb_t f, const gghlite_enc_limb_t g)
+{
+    fmpz_mod_poly_oz_limb_add(h, f, g, self->q_limbs);
+}
+
+/**
+   @brief Compute $h = f-g$ for limb encodings.
+
+   @param h         initialised limb encoding, return value
+   @param self      initialised GGHLite `params`
+   @param f         valid limb encoding
+   @param g         valid limb encoding
+
+   @ingroup encodings
+*/
+
+static inline void
+gghlite_enc_limb_sub(gghlite_enc_limb_t h, const gghlite_params_t self,
+                     const gghlite_enc_limb_t f, const gghlite_enc_limb_t g)
+{
+    fmpz_mod_poly_oz_limb_sub(h, f, g, self->q_limbs);
+}
+
 #ifdef __cplusplus
 }
 #endif
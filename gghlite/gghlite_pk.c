@@ -1,3 +1,4 @@
+#include <stdlib.h>
 #include <string.h>
 
 #include "gghlite-internals.h"
@@ -107,14 +108,36 @@ _gghlite_params_set_q(gghlite_params_t self)
     mpfr_clear(log_q_base);
     mpfr_clear(q_base);
 
+    if (self->flags & GGHLITE_FLAGS_RNS) {
+        /* q = ∏ p_i with p_i ≡ 1 mod 2n, p_i < 2^60 and at least as many bits as requested */
+        fmpz_mod_poly_oz_rns_modulus(self->q, self->n, fmpz_sizeinbase(self->q, 2));
+        return;
+    }
+
+    if (self->flags & GGHLITE_FLAGS_SPARSE_Q) {
+        /* q = 2^k - c·2n + 1 ≥ q_min, falling back to k+1 if all candidates with k bits are too small */
+        fmpz_t q_min;
+        fmpz_init_set(q_min, self->q);
+        const mp_bitcnt_t k = fmpz_sizeinbase(q_min, 2);
+        const uint64_t t = ggh_walltime(0);
+        fmpz_mod_poly_oz_special_modulus(self->q, self->n, k);
+        if (fmpz_cmp(self->q, q_min) < 0)
+            fmpz_mod_poly_oz_special_modulus(self->q, self->n, k+1);
+        timer_printf("      Prime search for %ld-bit q: %8.2fs\n", fmpz_sizeinbase(self->q, 2),
+                     ggh_seconds(ggh_walltime(t)));
+        fmpz_clear(q_min);
+        return;
+    }
+
     fmpz_fdiv_q_2exp(self->q, self->q, n_flog(self->n,2)+1);
     fmpz_mul_2exp(self->q, self->q, n_flog(self->n,2)+1);
     fmpz_add_ui(self->q, self->q, 1);
-    while(1) {
-        if(fmpz_is_probabprime(self->q))
-            break;
-        fmpz_add_ui(self->q, self->q, 2*self->n);
-    }
+
+    /* sieved and tested in parallel, same result as testing q, q+2n, q+4n, … in turn */
+    const uint64_t t = ggh_walltime(0);
+    fmpz_next_probabprime_ap(self->q, self->q, 2*self->n, 0);
+    timer_printf("      Prime search for %ld-bit q: %8.2fs\n", fmpz_sizeinbase(self->q, 2),
+                 ggh_seconds(ggh_walltime(t)));
 }
 
 static void
@@ -556,6 +579,32 @@ gghlite_params_check_sec(const gghlite_params_t self)
     return ((rt0 >= self->lambda) && (rt1 >= self->lambda));
 }
 
+void
+_gghlite_params_set_zt_bound(gghlite_params_t self)
+{
+    mpfr_t bound;
+    mpfr_init2(bound, _gghlite_prec(self));
+    _gghlite_params_get_q_mpfr(bound, self, MPFR_RNDN);
+
+    /* q^{1-ξ} */
+    mpfr_t ex;
+    mpfr_init2(ex, _gghlite_prec(self));
+    mpfr_ui_sub(ex, 1, self->xi, MPFR_RNDN);
+    mpfr_pow(bound, bound, ex, MPFR_RNDN);
+    mpfr_clear(ex);
+
+    mpz_t t;
+    mpz_init(t);
+    mpfr_get_z(t, bound, MPFR_RNDD);
+    fmpz_set_mpz(self->zt_bound, t);
+
+    mpfr_sqr(bound, bound, MPFR_RNDN);
+    mpfr_get_z(t, bound, MPFR_RNDD);
+    fmpz_set_mpz(self->zt_bound_sq, t);
+    mpz_clear(t);
+    mpfr_clear(bound);
+}
+
 void
 gghlite_params_init_gamma(gghlite_params_t self, size_t lambda, size_t kappa,
                           size_t gamma, uint64_t rerand_mask,
@@ -570,27 +619,37 @@ gghlite_params_init_gamma(gghlite_params_t self, size_t lambda, size_t kappa,
     self->flags = flags;
 
     start_timer();
-    timer_printf("Starting setting q...\n");
-    int count = 0;
-    for(int log_n = 7; ; log_n++) {
-        self->n = ((long)1)<<log_n;
-        _gghlite_params_set_sigma(self);
-        _gghlite_params_set_ell_g(self);
-        _gghlite_params_set_ell(self);
-        _gghlite_params_set_sigma_p(self);
-        _gghlite_params_set_sigma_s(self);
-        _gghlite_params_set_q(self);
-
-        timer_printf("    Attempt #%d at setting q", ++count);
+    const char *cache = getenv(GGHLITE_PARAMS_CACHE_ENV);
+    if (cache && gghlite_params_cache_get(self, cache) == 0) {
+        timer_printf("Found q in cache %s", cache);
         print_timer();
-        timer_printf("\n"); 
+        timer_printf("\n");
+    } else {
+        timer_printf("Starting setting q...\n");
+        int count = 0;
+        for(int log_n = 7; ; log_n++) {
+            self->n = ((long)1)<<log_n;
+            _gghlite_params_set_sigma(self);
+            _gghlite_params_set_ell_g(self);
+            _gghlite_params_set_ell(self);
+            _gghlite_params_set_sigma_p(self);
+            _gghlite_params_set_sigma_s(self);
+            _gghlite_params_set_q(self);
 
-        if (gghlite_params_check_sec(self))
-            break;
+            timer_printf("    Attempt #%d at setting q", ++count);
+            print_timer();
+            timer_printf("\n");
+
+            if (gghlite_params_check_sec(self))
+                break;
+        }
+        timer_printf("Finished setting q");
+        print_timer();
+        timer_printf("\n");
     }
-    timer_printf("Finished setting q");
-    print_timer();
-    timer_printf("\n");
+
+    _gghlite_params_set_zt_bound(self);
+    fmpz_mod_oz_limb_ctx_init(self->q_limbs, self->q);
 
     if (self->flags & GGHLITE_FLAGS_VERBOSE)
         gghlite_params_print(self);
@@ -602,12 +661,19 @@ gghlite_params_clear(gghlite_params_t self)
     fmpz_mod_poly_clear(self->pzt);
 
     mpfr_clear(self->xi);
+    fmpz_clear(self->zt_bound);
+    fmpz_clear(self->zt_bound_sq);
     mpfr_clear(self->sigma_s);
     mpfr_clear(self->ell_b);
     mpfr_clear(self->sigma_p);
     mpfr_clear(self->ell_g);
     mpfr_clear(self->sigma);
     fmpz_mod_poly_oz_ntt_precomp_clear(self->ntt);
+    if (self->flags & GGHLITE_FLAGS_RNS) {
+        fmpz_mod_poly_oz_rns_clear(self->pzt_rns);
+        fmpz_mod_poly_oz_rns_precomp_clear(self->rns);
+    }
+    fmpz_mod_oz_limb_ctx_clear(self->q_limbs);
     fmpz_clear(self->q);
 }
 
@@ -0,0 +1,722 @@
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gghlite.h"
+#include "gghlite-internals.h"
+
+/* Files start with an 8-byte magic, the format version and a tag for what follows. Scalars are
+   written as 64-bit little-endian words, integers in GMP's portable raw format. */
+
+static const char _gghlite_io_magic[8] = {'G','G','H','L','I','T','E','\0'};
+
+#define GGHLITE_IO_PARAMS        1
+#define GGHLITE_IO_SK            2
+#define GGHLITE_IO_PARAMS_MAPPED 3
+#define GGHLITE_IO_ENC_MAPPED    4
+#define GGHLITE_IO_PARAMS_CACHE  5
+
+static int
+_gghlite_write_u64(FILE *fp, const uint64_t v)
+{
+    unsigned char buf[8];
+    for(int i=0; i<8; i++)
+        buf[i] = (v>>(8*i)) & 0xff;
+    return fwrite(buf, 1, 8, fp) != 8;
+}
+
+static int
+_gghlite_read_u64(uint64_t *v, FILE *fp)
+{
+    unsigned char buf[8];
+    if (fread(buf, 1, 8, fp) != 8)
+        return 1;
+    *v = 0;
+    for(int i=0; i<8; i++)
+        *v |= ((uint64_t)buf[i])<<(8*i);
+    return 0;
+}
+
+static int
+_gghlite_write_fmpz(FILE *fp, const fmpz_t op)
+{
+    return fmpz_out_raw(fp, op) == 0;
+}
+
+static int
+_gghlite_read_fmpz(fmpz_t rop, FILE *fp)
+{
+    return fmpz_inp_raw(rop, fp) == 0;
+}
+
+/* $x = m·2^e$ exactly, together with the precision of $x$ */
+
+static int
+_gghlite_write_mpfr(FILE *fp, const mpfr_t op)
+{
+    mpz_t m;
+    mpz_init(m);
+    const mpfr_exp_t e = mpfr_get_z_2exp(m, op);
+    int r = _gghlite_write_u64(fp, mpfr_get_prec(op));
+    r |= _gghlite_write_u64(fp, (uint64_t)(int64_t)e);
+    r |= mpz_out_raw(fp, m) == 0;
+    mpz_clear(m);
+    return r;
+}
+
+/* `rop` must be initialised, its precision is changed to the stored one */
+
+static int
+_gghlite_read_mpfr(mpfr_t rop, FILE *fp)
+{
+    uint64_t prec, e;
+    if (_gghlite_read_u64(&prec, fp) || _gghlite_read_u64(&e, fp))
+        return 1;
+    if (prec < MPFR_PREC_MIN || prec > MPFR_PREC_MAX)
+        return 1;
+    mpz_t m;
+    mpz_init(m);
+    int r = mpz_inp_raw(m, fp) == 0;
+    if (!r) {
+        mpfr_set_prec(rop, prec);
+        mpfr_set_z_2exp(rop, m, (mpfr_exp_t)(int64_t)e, MPFR_RNDN);
+    }
+    mpz_clear(m);
+    return r;
+}
+
+static int
+_gghlite_write_fmpz_vec(FILE *fp, const fmpz *vec, const long len)
+{
+    int r = _gghlite_write_u64(fp, len);
+    for(long i=0; i<len && !r; i++)
+        r |= _gghlite_write_fmpz(fp, vec + i);
+    return r;
+}
+
+/* `vec` must hold at least `max_len` entries, the number of entries read is returned in `len` */
+
+static int
+_gghlite_read_fmpz_vec(fmpz *vec, long *len, const long max_len, FILE *fp)
+{
+    uint64_t len_;
+    if (_gghlite_read_u64(&len_, fp) || len_ > (uint64_t)max_len)
+        return 1;
+    *len = len_;
+    for(long i=0; i<*len; i++)
+        if (_gghlite_read_fmpz(vec + i, fp))
+            return 1;
+    return 0;
+}
+
+static int
+_gghlite_write_fmpz_poly(FILE *fp, const fmpz_poly_t op)
+{
+    return _gghlite_write_fmpz_vec(fp, op->coeffs, fmpz_poly_length(op));
+}
+
+static int
+_gghlite_read_fmpz_poly(fmpz_poly_t rop, const long n, FILE *fp)
+{
+    long len = 0;
+    fmpz_poly_zero(rop);
+    fmpz_poly_fit_length(rop, n);
+    const int r = _gghlite_read_fmpz_vec(rop->coeffs, &len, n, fp);
+    _fmpz_poly_set_length(rop, len);
+    _fmpz_poly_normalise(rop);
+    return r;
+}
+
+static int
+_gghlite_write_fmpq_poly(FILE *fp, const fmpq_poly_t op)
+{
+    int r = _gghlite_write_fmpz(fp, fmpq_poly_denref(op));
+    r |= _gghlite_write_fmpz_vec(fp, op->coeffs, fmpq_poly_length(op));
+    return r;
+}
+
+static int
+_gghlite_read_fmpq_poly(fmpq_poly_t rop, const long n, FILE *fp)
+{
+    long len = 0;
+    fmpq_poly_zero(rop);
+    fmpq_poly_fit_length(rop, n);
+    int r = _gghlite_read_fmpz(fmpq_poly_denref(rop), fp);
+    r |= fmpz_sgn(fmpq_poly_denref(rop)) <= 0;
+    if (!r)
+        r |= _gghlite_read_fmpz_vec(rop->coeffs, &len, n, fp);
+    _fmpq_poly_set_length(rop, len);
+    _fmpq_poly_normalise(rop);
+    if (r)
+        fmpq_poly_zero(rop);
+    return r;
+}
+
+static int
+_gghlite_write_enc(FILE *fp, const gghlite_enc_t op)
+{
+    return _gghlite_write_fmpz_vec(fp, op->coeffs, fmpz_mod_poly_length(op));
+}
+
+/* `rop` must be initialised modulo $q$, coefficients are checked to be in $[0,q)$ */
+
+static int
+_gghlite_read_enc(gghlite_enc_t rop, const long n, FILE *fp)
+{
+    long len = 0;
+    fmpz_mod_poly_zero(rop);
+    fmpz_mod_poly_fit_length(rop, n);
+    int r = _gghlite_read_fmpz_vec(rop->coeffs, &len, n, fp);
+    for(long i=0; i<len && !r; i++)
+        r |= (fmpz_sgn(rop->coeffs + i) < 0) || (fmpz_cmp(rop->coeffs + i, fmpz_mod_poly_modulus(rop)) >= 0);
+    _fmpz_mod_poly_set_length(rop, len);
+    _fmpz_mod_poly_normalise(rop);
+    if (r)
+        fmpz_mod_poly_zero(rop);
+    return r;
+}
+
+static int
+_gghlite_write_header(FILE *fp, const uint64_t tag)
+{
+    int r = fwrite(_gghlite_io_magic, 1, sizeof(_gghlite_io_magic), fp) != sizeof(_gghlite_io_magic);
+    r |= _gghlite_write_u64(fp, GGHLITE_IO_VERSION);
+    r |= _gghlite_write_u64(fp, tag);
+    return r;
+}
+
+static int
+_gghlite_read_header(FILE *fp, const uint64_t tag)
+{
+    char magic[sizeof(_gghlite_io_magic)];
+    uint64_t version, tag_;
+    if (fread(magic, 1, sizeof(magic), fp) != sizeof(magic))
+        return 1;
+    if (memcmp(magic, _gghlite_io_magic, sizeof(magic)))
+        return 1;
+    if (_gghlite_read_u64(&version, fp) || version != GGHLITE_IO_VERSION)
+        return 1;
+    if (_gghlite_read_u64(&tag_, fp) || tag_ != tag)
+        return 1;
+    return 0;
+}
+
+static int
+_gghlite_params_write(FILE *fp, const gghlite_params_t self)
+{
+    assert(self->ntt->n == (size_t)self->n);
+
+    int r = 0;
+    r |= _gghlite_write_u64(fp, self->lambda);
+    r |= _gghlite_write_u64(fp, self->gamma);
+    r |= _gghlite_write_u64(fp, self->kappa);
+    r |= _gghlite_write_u64(fp, self->rerand_mask);
+    r |= _gghlite_write_u64(fp, self->flags);
+    r |= _gghlite_write_u64(fp, self->n);
+    r |= _gghlite_write_u64(fp, self->ell);
+
+    r |= _gghlite_write_fmpz(fp, self->q);
+    r |= _gghlite_write_mpfr(fp, self->sigma);
+    r |= _gghlite_write_mpfr(fp, self->sigma_p);
+    r |= _gghlite_write_mpfr(fp, self->sigma_s);
+    r |= _gghlite_write_mpfr(fp, self->ell_b);
+    r |= _gghlite_write_mpfr(fp, self->ell_g);
+    r |= _gghlite_write_mpfr(fp, self->xi);
+    r |= _gghlite_write_fmpz(fp, self->zt_bound);
+    r |= _gghlite_write_fmpz(fp, self->zt_bound_sq);
+
+    /* the NTT tables are O(n) multiplications away from φ = phi_br[brv(1)] = phi_br[n/2], finding
+       φ is the expensive part */
+    r |= _gghlite_write_fmpz(fp, self->ntt->phi_br->coeffs + self->n/2);
+
+    r |= _gghlite_write_enc(fp, self->pzt);
+    return r;
+}
+
+static int
+_gghlite_params_read(gghlite_params_t self, FILE *fp)
+{
+    uint64_t lambda, gamma, kappa, rerand_mask, flags, n, ell;
+    if (_gghlite_read_u64(&lambda, fp) || _gghlite_read_u64(&gamma, fp) || _gghlite_read_u64(&kappa, fp))
+        return 1;
+    if (_gghlite_read_u64(&rerand_mask, fp) || _gghlite_read_u64(&flags, fp))
+        return 1;
+    if (_gghlite_read_u64(&n, fp) || _gghlite_read_u64(&ell, fp))
+        return 1;
+    if (!lambda || !gamma || !kappa || n < 2 || (n & (n-1)) || n > ((uint64_t)1)<<40)
+        return 1;
+
+    gghlite_params_initzero(self, lambda, kappa, gamma);
+    self->rerand_mask = rerand_mask;
+    self->flags = flags;
+    self->n = n;
+    self->ell = ell;
+
+    fmpz_init(self->q);
+    fmpz_init(self->zt_bound);
+    fmpz_init(self->zt_bound_sq);
+    fmpz_t phi;
+    fmpz_init(phi);
+
+    int r = 0;
+    r |= _gghlite_read_fmpz(self->q, fp);
+    r |= fmpz_cmp_ui(self->q, 2) < 0;
+    if (!r) r |= _gghlite_read_mpfr(self->sigma, fp);
+    if (!r) r |= _gghlite_read_mpfr(self->sigma_p, fp);
+    if (!r) r |= _gghlite_read_mpfr(self->sigma_s, fp);
+    if (!r) r |= _gghlite_read_mpfr(self->ell_b, fp);
+    if (!r) r |= _gghlite_read_mpfr(self->ell_g, fp);
+    if (!r) r |= _gghlite_read_mpfr(self->xi, fp);
+    if (!r) r |= _gghlite_read_fmpz(self->zt_bound, fp);
+    if (!r) r |= _gghlite_read_fmpz(self->zt_bound_sq, fp);
+    if (!r) r |= _gghlite_read_fmpz(phi, fp);
+    if (!r) {
+        /* φ must be a primitive 2n-th root of unity, i.e. φ^n ≡ -1 mod q, or all encodings are garbage */
+        fmpz_t t;
+        fmpz_init(t);
+        r |= fmpz_sgn(phi) <= 0 || fmpz_cmp(phi, self->q) >= 0;
+        if (!r) {
+            fmpz_powm_ui(t, phi, self->n, self->q);
+            fmpz_add_ui(t, t, 1);
+            r |= !fmpz_equal(t, self->q);
+        }
+        fmpz_clear(t);
+    }
+
+    fmpz_mod_poly_init(self->pzt, self->q);
+    if (!r) r |= _gghlite_read_enc(self->pzt, self->n, fp);
+
+    if (r) {
+        fmpz_clear(phi);
+        fmpz_mod_poly_clear(self->pzt);
+        mpfr_clear(self->xi);
+        mpfr_clear(self->sigma_s);
+        mpfr_clear(self->ell_b);
+        mpfr_clear(self->sigma_p);
+        mpfr_clear(self->ell_g);
+        mpfr_clear(self->sigma);
+        fmpz_clear(self->zt_bound_sq);
+        fmpz_clear(self->zt_bound);
+        fmpz_clear(self->q);
+        memset(self, 0, sizeof(struct _gghlite_params_struct));
+        return r;
+    }
+
+    if (self->flags & GGHLITE_FLAGS_RNS) {
+        /* the primes are recovered from q, φ is the CRT of the roots found there */
+        fmpz_mod_poly_oz_rns_precomp_init(self->rns, self->n, self->q);
+        fmpz_mod_poly_oz_ntt_precomp_init_rns(self->ntt, self->rns);
+        fmpz_mod_poly_oz_rns_init(self->pzt_rns, self->rns);
+        fmpz_mod_poly_oz_rns_set_fmpz_mod_poly(self->pzt_rns, self->pzt, self->rns);
+    } else {
+        _fmpz_mod_poly_oz_ntt_precomp_init_phi(self->ntt, self->n, self->q, phi);
+    }
+    fmpz_mod_oz_limb_ctx_init(self->q_limbs, self->q);
+    fmpz_clear(phi);
+    return 0;
+}
+
+int
+gghlite_params_save(FILE *fp, const gghlite_params_t self)
+{
+    int r = _gghlite_write_header(fp, GGHLITE_IO_PARAMS);
+    r |= _gghlite_params_write(fp, self);
+    return r ? -1 : 0;
+}
+
+int
+gghlite_params_load(gghlite_params_t self, FILE *fp)
+{
+    memset(self, 0, sizeof(struct _gghlite_params_struct));
+    if (_gghlite_read_header(fp, GGHLITE_IO_PARAMS))
+        return -1;
+    return _gghlite_params_read(self, fp) ? -1 : 0;
+}
+
+int
+gghlite_sk_save(FILE *fp, const gghlite_sk_t self)
+{
+    assert(self->D_g);
+    assert(self->D_g->call == dgsl_rot_mp_call_inlattice);
+
+    const size_t bound = (gghlite_sk_is_symmetric(self)) ? 1 : self->params->gamma;
+
+    int r = _gghlite_write_header(fp, GGHLITE_IO_SK);
+    r |= _gghlite_params_write(fp, self->params);
+
+    r |= _gghlite_write_fmpz_poly(fp, self->g);
+    r |= _gghlite_write_fmpq_poly(fp, self->g_inv);
+    r |= _gghlite_write_fmpz_poly(fp, self->h);
+
+    r |= _gghlite_write_u64(fp, bound);
+    for(size_t i=0; i<bound && !r; i++) {
+        r |= _gghlite_write_enc(fp, self->z[i]);
+        r |= _gghlite_write_enc(fp, self->z_inv[i]);
+    }
+
+    /* D_g: the basis is g, the rest is cheap to recompute */
+    r |= _gghlite_write_mpfr(fp, self->D_g->sigma);
+    r |= _gghlite_write_fmpq_poly(fp, self->D_g->B_inv);
+    r |= _gghlite_write_fmpq_poly(fp, self->D_g->sigma_sqrt);
+    return r ? -1 : 0;
+}
+
+int
+gghlite_sk_load(gghlite_sk_t self, FILE *fp, aes_randstate_t randstate)
+{
+    memset(self, 0, sizeof(struct _gghlite_sk_struct));
+    if (_gghlite_read_header(fp, GGHLITE_IO_SK))
+        return -1;
+    if (_gghlite_params_read(self->params, fp))
+        return -1;
+
+    const long n = self->params->n;
+    const size_t bound = (gghlite_sk_is_symmetric(self)) ? 1 : self->params->gamma;
+
+    fmpz_poly_init(self->g);
+    fmpq_poly_init(self->g_inv);
+    fmpz_poly_init(self->h);
+    self->z     = calloc(self->params->gamma, sizeof(gghlite_enc_t));
+    self->z_inv = calloc(self->params->gamma, sizeof(gghlite_enc_t));
+    _gghlite_sk_z_cache_init(self);
+    _gghlite_sk_ntt_ws_init(self);
+    self->D_g_pool = NULL;
+    for(size_t i=0; i<bound; i++) {
+        fmpz_mod_poly_init(self->z[i], self->params->q);
+        fmpz_mod_poly_init(self->z_inv[i], self->params->q);
+    }
+
+    mpfr_t sigma;
+    mpfr_init2(sigma, _gghlite_prec(self->params));
+    fmpq_poly_t B_inv;       fmpq_poly_init(B_inv);
+    fmpq_poly_t sigma_sqrt;  fmpq_poly_init(sigma_sqrt);
+
+    int r = 0;
+    r |= _gghlite_read_fmpz_poly(self->g, n, fp);
+    if (!r) r |= _gghlite_read_fmpq_poly(self->g_inv, n, fp);
+    if (!r) r |= _gghlite_read_fmpz_poly(self->h, n, fp);
+
+    uint64_t bound_;
+    if (!r) r |= _gghlite_read_u64(&bound_, fp) || bound_ != bound;
+    for(size_t i=0; i<bound && !r; i++) {
+        r |= _gghlite_read_enc(self->z[i], n, fp);
+        if (!r) r |= _gghlite_read_enc(self->z_inv[i], n, fp);
+    }
+
+    if (!r) r |= _gghlite_read_mpfr(sigma, fp);
+    if (!r) r |= mpfr_cmp_ui(sigma, 0) <= 0;
+    if (!r) r |= _gghlite_read_fmpq_poly(B_inv, n, fp);
+    if (!r) r |= _gghlite_read_fmpq_poly(sigma_sqrt, n, fp);
+    if (!r) r |= fmpz_poly_is_zero(self->g);
+
+    if (!r)
+        self->D_g = dgsl_rot_mp_init_inlattice(n, self->g, sigma, B_inv, sigma_sqrt);
+
+    fmpq_poly_clear(sigma_sqrt);
+    fmpq_poly_clear(B_inv);
+    mpfr_clear(sigma);
+
+    if (r) {
+        gghlite_sk_clear(self, 1);
+        memset(self, 0, sizeof(struct _gghlite_sk_struct));
+        return -1;
+    }
+
+    _gghlite_sk_init_rng(self, randstate);
+    return 0;
+}
+
+/* Mappable files consist of a header of 64-bit words — magic, version, tag, n, L and a tag specific
+   word — followed by limb arrays, so all arrays are 8-byte aligned. */
+
+#define GGHLITE_IO_MAPPED_HEADER 6
+
+static int
+_gghlite_write_mapped_header(FILE *fp, const uint64_t tag, const uint64_t n, const uint64_t L, const uint64_t extra)
+{
+    int r = _gghlite_write_header(fp, tag);
+    r |= _gghlite_write_u64(fp, n);
+    r |= _gghlite_write_u64(fp, L);
+    r |= _gghlite_write_u64(fp, extra);
+    return r;
+}
+
+/* map all of `fp` and check its header, on success `hdr` holds the header words following the magic */
+
+static int
+_gghlite_map(void **base, size_t *size, uint64_t *hdr, FILE *fp, const uint64_t tag)
+{
+    if (!oz_limb_is_native())
+        return 1;
+
+    struct stat st;
+    const int fd = fileno(fp);
+    if (fd < 0 || fstat(fd, &st) || (size_t)st.st_size < 8*GGHLITE_IO_MAPPED_HEADER)
+        return 1;
+
+    void *p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        return 1;
+
+    const uint64_t *w = (const uint64_t *)p;
+    if (memcmp(p, _gghlite_io_magic, sizeof(_gghlite_io_magic)) || w[1] != GGHLITE_IO_VERSION || w[2] != tag) {
+        munmap(p, st.st_size);
+        return 1;
+    }
+    for(int i=0; i<GGHLITE_IO_MAPPED_HEADER-1; i++)
+        hdr[i] = w[i+1];
+    *base = p;
+    *size = st.st_size;
+    return 0;
+}
+
+int
+gghlite_params_save_mapped(FILE *fp, const gghlite_params_t self)
+{
+    const size_t n = self->n;
+    const size_t L = fmpz_oz_limb_width(self->q);
+
+    int r = _gghlite_write_mapped_header(fp, GGHLITE_IO_PARAMS_MAPPED, n, L, 0);
+    r |= fmpz_oz_limb_write(fp, self->q, L);
+    r |= fmpz_oz_limb_write(fp, self->ntt->n_inv, L);
+    r |= fmpz_oz_limb_write(fp, self->zt_bound, L);
+    r |= fmpz_oz_limb_write(fp, self->zt_bound_sq, 2*L);
+    r |= fmpz_mod_poly_oz_limb_write(fp, self->pzt, n, L);
+    r |= fmpz_mod_poly_oz_limb_write(fp, self->ntt->phi_br, n, L);
+    r |= fmpz_mod_poly_oz_limb_write(fp, self->ntt->phi_inv_br, n, L);
+    return r ? -1 : 0;
+}
+
+int
+gghlite_params_map(gghlite_params_map_t self, FILE *fp)
+{
+    memset(self, 0, sizeof(struct _gghlite_params_map_struct));
+
+    uint64_t hdr[GGHLITE_IO_MAPPED_HEADER-1];
+    if (_gghlite_map(&self->base, &self->size, hdr, fp, GGHLITE_IO_PARAMS_MAPPED))
+        return -1;
+
+    const uint64_t n = hdr[2], L = hdr[3];
+    const mp_limb_t *data = (const mp_limb_t *)self->base + GGHLITE_IO_MAPPED_HEADER;
+    if (n < 2 || (n & (n-1)) || L == 0 || L > ((uint64_t)1)<<20 || n > ((uint64_t)1)<<40 ||
+        self->size != 8*(GGHLITE_IO_MAPPED_HEADER + 5*L + 3*n*L) || data[L-1] == 0) {
+        munmap(self->base, self->size);
+        memset(self, 0, sizeof(struct _gghlite_params_map_struct));
+        return -1;
+    }
+
+    self->n = n;
+    fmpz_mod_oz_limb_ctx_init_mpn(self->q, data, L);
+    self->n_inv       = data + L;
+    self->zt_bound    = data + 2*L;
+    self->zt_bound_sq = data + 3*L;
+    fmpz_mod_poly_oz_limb_view(self->pzt,        data + 5*L,         n, L);
+    fmpz_mod_poly_oz_limb_view(self->phi_br,     data + 5*L +   n*L, n, L);
+    fmpz_mod_poly_oz_limb_view(self->phi_inv_br, data + 5*L + 2*n*L, n, L);
+    return 0;
+}
+
+void
+gghlite_params_unmap(gghlite_params_map_t self)
+{
+    fmpz_mod_oz_limb_ctx_clear(self->q);
+    munmap(self->base, self->size);
+}
+
+int
+gghlite_enc_save_mapped(FILE *fp, const gghlite_params_t self, const gghlite_enc_t *ops, const size_t count)
+{
+    const size_t n = self->n;
+    const size_t L = fmpz_oz_limb_width(self->q);
+
+    int r = _gghlite_write_mapped_header(fp, GGHLITE_IO_ENC_MAPPED, n, L, count);
+    for(size_t i=0; i<count && !r; i++)
+        r |= fmpz_mod_poly_oz_limb_write(fp, ops[i], n, L);
+    return r ? -1 : 0;
+}
+
+int
+gghlite_enc_map(gghlite_enc_map_t self, FILE *fp)
+{
+    memset(self, 0, sizeof(struct _gghlite_enc_map_struct));
+
+    uint64_t hdr[GGHLITE_IO_MAPPED_HEADER-1];
+    if (_gghlite_map(&self->base, &self->size, hdr, fp, GGHLITE_IO_ENC_MAPPED))
+        return -1;
+
+    const uint64_t n = hdr[2], L = hdr[3], count = hdr[4];
+    if (n < 2 || (n & (n-1)) || L == 0 || L > ((uint64_t)1)<<20 || n > ((uint64_t)1)<<40 ||
+        count > (self->size/8)/(n*L) || self->size != 8*(GGHLITE_IO_MAPPED_HEADER + count*n*L)) {
+        munmap(self->base, self->size);
+        memset(self, 0, sizeof(struct _gghlite_enc_map_struct));
+        return -1;
+    }
+
+    self->n = n;
+    self->L = L;
+    self->count = count;
+    self->coeffs = (const mp_limb_t *)self->base + GGHLITE_IO_MAPPED_HEADER;
+    return 0;
+}
+
+void
+gghlite_enc_unmap(gghlite_enc_map_t self)
+{
+    munmap(self->base, self->size);
+}
+
+/* A parameter cache is a header followed by entries, each the key (λ, κ, γ, rerand_mask, flags)
+   followed by the output of the search over n in `gghlite_params_init_gamma()`. */
+
+static int
+_gghlite_params_cache_write(FILE *fp, const gghlite_params_t self)
+{
+    int r = 0;
+    r |= _gghlite_write_u64(fp, self->lambda);
+    r |= _gghlite_write_u64(fp, self->kappa);
+    r |= _gghlite_write_u64(fp, self->gamma);
+    r |= _gghlite_write_u64(fp, self->rerand_mask);
+    r |= _gghlite_write_u64(fp, self->flags & GGHLITE_PARAMS_CACHE_FLAGS);
+    r |= _gghlite_write_u64(fp, self->n);
+    r |= _gghlite_write_u64(fp, self->ell);
+
+    r |= _gghlite_write_fmpz(fp, self->q);
+    r |= _gghlite_write_mpfr(fp, self->xi);
+    r |= _gghlite_write_mpfr(fp, self->sigma);
+    r |= _gghlite_write_mpfr(fp, self->ell_g);
+    r |= _gghlite_write_mpfr(fp, self->sigma_p);
+    r |= _gghlite_write_mpfr(fp, self->sigma_s);
+    return r;
+}
+
+/* only the fields of `self` covered by a cache entry are initialised */
+
+static void
+_gghlite_params_cache_entry_init(gghlite_params_t entry, const gghlite_params_t self)
+{
+    gghlite_params_initzero(entry, self->lambda, self->kappa, self->gamma);
+    fmpz_init(entry->q);
+    entry->rerand_mask = self->rerand_mask;
+    entry->flags = self->flags;
+}
+
+static void
+_gghlite_params_cache_entry_clear(gghlite_params_t entry)
+{
+    fmpz_clear(entry->q);
+    mpfr_clear(entry->xi);
+    mpfr_clear(entry->sigma_s);
+    mpfr_clear(entry->ell_b);
+    mpfr_clear(entry->sigma_p);
+    mpfr_clear(entry->ell_g);
+    mpfr_clear(entry->sigma);
+}
+
+/* `entry` as produced by `_gghlite_params_cache_entry_init()` is overwritten by the next entry */
+
+static int
+_gghlite_params_cache_read(gghlite_params_t entry, FILE *fp)
+{
+    uint64_t lambda, kappa, gamma, rerand_mask, flags, n, ell;
+    if (_gghlite_read_u64(&lambda, fp) || _gghlite_read_u64(&kappa, fp) || _gghlite_read_u64(&gamma, fp))
+        return 1;
+    if (_gghlite_read_u64(&rerand_mask, fp) || _gghlite_read_u64(&flags, fp))
+        return 1;
+    if (_gghlite_read_u64(&n, fp) || _gghlite_read_u64(&ell, fp))
+        return 1;
+    if (n < 2 || (n & (n-1)) || n > ((uint64_t)1)<<40)
+        return 1;
+
+    entry->lambda = lambda;
+    entry->kappa = kappa;
+    entry->gamma = gamma;
+    entry->rerand_mask = rerand_mask;
+    entry->flags = (gghlite_flag_t)flags;
+    entry->n = n;
+    entry->ell = ell;
+
+    int r = _gghlite_read_fmpz(entry->q, fp);
+    if (!r) r |= _gghlite_read_mpfr(entry->xi, fp);
+    if (!r) r |= _gghlite_read_mpfr(entry->sigma, fp);
+    if (!r) r |= _gghlite_read_mpfr(entry->ell_g, fp);
+    if (!r) r |= _gghlite_read_mpfr(entry->sigma_p, fp);
+    if (!r) r |= _gghlite_read_mpfr(entry->sigma_s, fp);
+    return r;
+}
+
+/* scan `fp` from the start, return 1 and set `self` on a hit, 0 on a miss and -1 if `fp` is not a
+   parameter cache */
+
+static int
+_gghlite_params_cache_find(gghlite_params_t self, FILE *fp)
+{
+    if (_gghlite_read_header(fp, GGHLITE_IO_PARAMS_CACHE))
+        return -1;
+
+    gghlite_params_t entry;
+    _gghlite_params_cache_entry_init(entry, self);
+
+    int found = 0;
+    while(!found && !_gghlite_params_cache_read(entry, fp)) {
+        found = (entry->lambda == self->lambda) && (entry->kappa == self->kappa) &&
+            (entry->gamma == self->gamma) && (entry->rerand_mask == self->rerand_mask) &&
+            (entry->flags == (self->flags & GGHLITE_PARAMS_CACHE_FLAGS));
+    }
+
+    if (found) {
+        self->n = entry->n;
+        self->ell = entry->ell;
+        fmpz_set(self->q, entry->q);
+        mpfr_set(self->xi, entry->xi, MPFR_RNDN);
+        mpfr_set(self->sigma, entry->sigma, MPFR_RNDN);
+        mpfr_set(self->ell_g, entry->ell_g, MPFR_RNDN);
+        mpfr_set(self->sigma_p, entry->sigma_p, MPFR_RNDN);
+        mpfr_set(self->sigma_s, entry->sigma_s, MPFR_RNDN);
+    }
+
+    _gghlite_params_cache_entry_clear(entry);
+    return found;
+}
+
+int
+gghlite_params_cache_get(gghlite_params_t self, const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return -1;
+    const int found = _gghlite_params_cache_find(self, fp);
+    fclose(fp);
+    return (found == 1) ? 0 : -1;
+}
+
+int
+gghlite_params_cache_add(const char *path, const gghlite_params_t self)
+{
+    /* writes always go to the end of the file, reads may go anywhere */
+    FILE *fp = fopen(path, "a+b");
+    if (!fp)
+        return -1;
+
+    int r = fseek(fp, 0, SEEK_END) != 0;
+    const long size = ftell(fp);
+    r |= size < 0;
+
+    if (!r && size == 0) {
+        r |= _gghlite_write_header(fp, GGHLITE_IO_PARAMS_CACHE);
+    } else if (!r) {
+        gghlite_params_t tmp;
+        _gghlite_params_cache_entry_init(tmp, self);
+        rewind(fp);
+        const int found = _gghlite_params_cache_find(tmp, fp);
+        _gghlite_params_cache_entry_clear(tmp);
+        if (found) {
+            fclose(fp);
+            return (found == 1) ? 0 : -1;
+        }
+        r |= fseek(fp, 0, SEEK_END) != 0;
+    }
+
+    if (!r)
+        r |= _gghlite_params_cache_write(fp, self);
+    r |= fclose(fp) != 0;
+    return r ? -1 : 0;
+}
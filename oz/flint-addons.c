@@ -1,4 +1,5 @@
 #include <omp.h>
+#include <string.h>
 #include "flint-addons.h"
 
 /**
@@ -12,6 +13,119 @@ void fmpz_init_exp(fmpz_t exp, int base, int n) {
   fmpz_clear(tmp);
 }
 
+/**
+   Return array of all primes below `bound`, the number of primes is written to `k`.
+*/
+
+static mp_limb_t *_n_primes_below(const mp_limb_t bound, size_t *k) {
+  char *composite = (char*)calloc(bound, sizeof(char));
+  mp_limb_t *primes = (mp_limb_t*)calloc(bound/2 + 1, sizeof(mp_limb_t));
+  *k = 0;
+  for(mp_limb_t p=2; p<bound; p++) {
+    if (composite[p])
+      continue;
+    primes[(*k)++] = p;
+    for(mp_limb_t j=p*p; j<bound; j+=p)
+      composite[j] = 1;
+  }
+  free(composite);
+  return primes;
+}
+
+int fmpz_next_probabprime_ap(fmpz_t rop, const fmpz_t q0, const slong s, const ulong count) {
+  assert(s != 0);
+  assert(fmpz_sgn(q0) > 0);
+  assert(s > 0 || count > 0);
+
+  /* a candidate below the bound would be sieved out by itself */
+  fmpz_t c;  fmpz_init(c);
+  fmpz_set_si(c, s);
+  fmpz_mul_ui(c, c, count ? count - 1 : 0);
+  fmpz_add(c, c, q0);
+  const int sieve = fmpz_cmp_ui(q0, FMPZ_SIEVE_BOUND) > 0 && fmpz_cmp_ui(c, FMPZ_SIEVE_BOUND) > 0;
+
+  /* candidate i is divisible by p iff i ≡ i_p mod p, with i_p = p if this never happens */
+  size_t k = 0;
+  mp_limb_t *primes = NULL, *start = NULL;
+  if (sieve) {
+    primes = _n_primes_below(FMPZ_SIEVE_BOUND, &k);
+    start = (mp_limb_t*)calloc(k, sizeof(mp_limb_t));
+    for(size_t j=0; j<k; j++) {
+      const mp_limb_t p = primes[j];
+      const mp_limb_t r = fmpz_fdiv_ui(q0, p);
+      const mp_limb_t sp = (s > 0) ? ((mp_limb_t)s) % p : (p - ((mp_limb_t)-s) % p) % p;
+      if (sp == 0 && r == 0) {
+        /* p divides every candidate */
+        free(start);
+        free(primes);
+        fmpz_clear(c);
+        return 0;
+      }
+      if (sp == 0)
+        start[j] = p;
+      else
+        start[j] = n_mulmod2_preinv((p - r) % p, n_invmod(sp, p), p, n_preinvert_limb(p));
+    }
+  }
+
+  char *composite = (char*)calloc(FMPZ_SIEVE_BLOCK, sizeof(char));
+  ulong *survivors = (ulong*)calloc(FMPZ_SIEVE_BLOCK, sizeof(ulong));
+  int found = 0;
+
+  for(ulong base=0; !found && (count == 0 || base < count); base += FMPZ_SIEVE_BLOCK) {
+    const ulong len = (count && count - base < FMPZ_SIEVE_BLOCK) ? count - base : FMPZ_SIEVE_BLOCK;
+
+    memset(composite, 0, len);
+    for(size_t j=0; j<k; j++) {
+      const mp_limb_t p = primes[j];
+      if (start[j] == p)
+        continue;
+      for(ulong i = (start[j] + p - base % p) % p; i < len; i += p)
+        composite[i] = 1;
+    }
+    size_t ns = 0;
+    for(ulong i=0; i<len; i++)
+      if (!composite[i])
+        survivors[ns++] = i;
+
+    ulong best = len;
+#pragma omp parallel for schedule(dynamic, 1)
+    for(size_t t=0; t<ns; t++) {
+      ulong best_so_far;
+#pragma omp atomic read
+      best_so_far = best;
+      if (survivors[t] > best_so_far)
+        continue;
+      fmpz_t x;  fmpz_init(x);
+      fmpz_set_si(x, s);
+      fmpz_mul_ui(x, x, base + survivors[t]);
+      fmpz_add(x, x, q0);
+      if (fmpz_is_probabprime(x)) {
+#pragma omp critical(fmpz_next_probabprime_ap)
+        if (survivors[t] < best) {
+#pragma omp atomic write
+          best = survivors[t];
+        }
+      }
+      fmpz_clear(x);
+    }
+
+    if (best < len) {
+      fmpz_set_si(c, s);
+      fmpz_mul_ui(c, c, base + best);
+      fmpz_add(rop, c, q0);
+      found = 1;
+    }
+  }
+
+  free(survivors);
+  free(composite);
+  free(start);
+  free(primes);
+  fmpz_clear(c);
+  return found;
+}
+
 void fmpz_mat_mul_modp(fmpz_mat_t a, fmpz_mat_t b, fmpz_mat_t c, int n,
     fmpz_t p) {
   fmpz_mat_mul(a, b, c);
@@ -34,6 +34,39 @@ static inline mp_limb_t n_prevprime(mp_limb_t n, int proved) {
   return n;
 }
 
+/**
+   @brief Candidates of `fmpz_next_probabprime_ap()` are sieved by primes below this bound.
+*/
+
+#ifndef FMPZ_SIEVE_BOUND
+#define FMPZ_SIEVE_BOUND (1UL<<16)
+#endif
+
+/**
+   @brief Number of candidates `fmpz_next_probabprime_ap()` sieves at once.
+*/
+
+#ifndef FMPZ_SIEVE_BLOCK
+#define FMPZ_SIEVE_BLOCK (1UL<<14)
+#endif
+
+/**
+   @brief Set `rop` to the first probable prime in $q_0, q_0 + s, q_0 + 2s, …$
+
+   Candidates are sieved in blocks of `FMPZ_SIEVE_BLOCK` by all primes below `FMPZ_SIEVE_BOUND`.
+   The survivors of a block are tested with `fmpz_is_probabprime()` by all OpenMP threads. A thread
+   skips candidates beyond the first prime found so far, so the result is the same as for a
+   sequential search.
+
+   @param rop    return value, may alias `q0`
+   @param q0     first candidate, $q_0 > 0$
+   @param s      step $s ≠ 0$
+   @param count  maximal number of candidates to consider or 0 for no limit, must be positive if $s < 0$
+   @return 1 if a probable prime was found, 0 otherwise
+*/
+
+int fmpz_next_probabprime_ap(fmpz_t rop, const fmpz_t q0, const slong s, const ulong count);
+
 static inline void fmpq_set_mpfr(fmpq_t rop, const mpfr_t op, mpfr_rnd_t rnd) {
   mpf_t  op_f;
   mpf_init2(op_f, mpfr_get_prec(op));
@@ -0,0 +1,478 @@
+#include <assert.h>
+#include <string.h>
+#include <omp.h>
+#include "limb.h"
+#include "flint-addons.h"
+#include "ntt.h"
+#include "util.h"
+
+/**
+   Compute μ, R² and the word inverse for `ctx->q` and fix the number of threads.
+*/
+
+static void _fmpz_mod_oz_limb_ctx_precomp(fmpz_mod_oz_limb_ctx_t ctx) {
+  const size_t L = ctx->L;
+
+  /* μ = ⌊B^{2L}/q⌋ and B^{2L} mod q with B = 2^64, μ < B^{L+1} unless q is a power of B */
+  mp_limb_t *t = (mp_limb_t*)calloc(2*L + 1 + L + 2, sizeof(mp_limb_t));
+  mp_limb_t *quo = t + 2*L + 1;
+  t[2*L] = 1;
+  ctx->mu = (mp_limb_t*)calloc(L + 1, sizeof(mp_limb_t));
+  ctx->r2 = (mp_limb_t*)calloc(L, sizeof(mp_limb_t));
+  mpn_tdiv_qr(quo, ctx->r2, 0, t, 2*L + 1, ctx->q, L);
+  if (quo[L+1])
+    oz_die("modulus must not be a power of 2^64");
+  mpn_copyi(ctx->mu, quo, L + 1);
+  free(t);
+
+  /* q = 2^k - d, folding 2^k ≡ d pays off if d is short compared to q */
+  ctx->k = FLINT_BITS*(L-1) + FLINT_BIT_COUNT(ctx->q[L-1]);
+  ctx->dn = 0;
+  ctx->d = NULL;
+  mp_limb_t *d = (mp_limb_t*)calloc(L + 1, sizeof(mp_limb_t));
+  d[ctx->k/FLINT_BITS] = ((mp_limb_t)1) << (ctx->k%FLINT_BITS);
+  mpn_sub(d, d, L + 1, ctx->q, L);
+  size_t dn = L;
+  while (dn > 0 && d[dn-1] == 0)
+    dn--;
+  if (dn > 0 && OZ_LIMB_SPECIAL_FACTOR*dn <= L) {
+    ctx->dn = dn;
+    ctx->d = d;
+  } else {
+    free(d);
+  }
+
+  /* Newton iteration for q^{-1} mod 2^64, q·q ≡ 1 mod 8 gives three correct bits to start from */
+  ctx->qinv = 0;
+  if (ctx->q[0] & 1) {
+    mp_limb_t inv = ctx->q[0];
+    for(int i=0; i<5; i++)
+      inv *= 2 - ctx->q[0]*inv;
+    ctx->qinv = -inv;
+  }
+
+  ctx->num_threads = fmpz_mod_poly_oz_ntt_num_threads();
+}
+
+void fmpz_mod_oz_limb_ctx_init(fmpz_mod_oz_limb_ctx_t ctx, const fmpz_t q) {
+  assert(fmpz_sgn(q) > 0);
+  ctx->L = fmpz_oz_limb_width(q);
+  ctx->q = (mp_limb_t*)calloc(ctx->L, sizeof(mp_limb_t));
+  fmpz_get_oz_limbs(ctx->q, q, ctx->L);
+  _fmpz_mod_oz_limb_ctx_precomp(ctx);
+}
+
+void fmpz_mod_oz_limb_ctx_init_mpn(fmpz_mod_oz_limb_ctx_t ctx, const mp_limb_t *q, const size_t L) {
+  assert(L > 0 && q[L-1] != 0);
+  ctx->L = L;
+  ctx->q = (mp_limb_t*)calloc(L, sizeof(mp_limb_t));
+  mpn_copyi(ctx->q, q, L);
+  _fmpz_mod_oz_limb_ctx_precomp(ctx);
+}
+
+void fmpz_mod_oz_limb_ctx_clear(fmpz_mod_oz_limb_ctx_t ctx) {
+  free(ctx->d);
+  free(ctx->r2);
+  free(ctx->mu);
+  free(ctx->q);
+}
+
+void fmpz_mod_poly_oz_special_modulus(fmpz_t q, const size_t n, const mp_bitcnt_t k) {
+  assert(n > 0 && (n & (n-1)) == 0);
+  const mp_bitcnt_t log_2n = n_flog(2*n, 2);
+  assert(k > log_2n + 1);
+
+  /* c = 1, 2, … while q ≥ 2^{k-1} */
+  const mp_bitcnt_t log_count = k - 1 - log_2n;
+  const ulong count = (log_count < FLINT_BITS - 2) ? ((ulong)1) << log_count : ((ulong)1) << (FLINT_BITS - 2);
+  fmpz_zero(q);
+  fmpz_setbit(q, k);
+  fmpz_add_ui(q, q, 1);
+  fmpz_sub_ui(q, q, 2*n);
+  if (!fmpz_next_probabprime_ap(q, q, -(slong)(2*n), count))
+    oz_die("no prime of the form 2^%lu - c·%zu + 1", (unsigned long)k, 2*n);
+}
+
+void fmpz_mod_poly_oz_limb_init(fmpz_mod_poly_oz_limb_t op, const size_t n, const fmpz_mod_oz_limb_ctx_t ctx) {
+  op->n = n;
+  op->L = ctx->L;
+  op->coeffs = (mp_limb_t*)calloc(n*ctx->L, sizeof(mp_limb_t));
+  if (!op->coeffs)
+    oz_die("out of memory");
+}
+
+void fmpz_mod_poly_oz_limb_clear(fmpz_mod_poly_oz_limb_t op) {
+  free(op->coeffs);
+}
+
+void fmpz_get_oz_limbs(mp_limb_t *rop, const fmpz_t a, const size_t L) {
+  assert(fmpz_sgn(a) >= 0);
+  if (!COEFF_IS_MPZ(*a)) {
+    rop[0] = (mp_limb_t)*a;
+    if (L > 1)
+      mpn_zero(rop + 1, L - 1);
+    return;
+  }
+  const __mpz_struct *z = COEFF_TO_PTR(*a);
+  const size_t s = mpz_size(z);
+  if (s > L)
+    oz_die("integer does not fit into %zu limbs", L);
+  mpn_copyi(rop, mpz_limbs_read(z), s);
+  if (s < L)
+    mpn_zero(rop + s, L - s);
+}
+
+void fmpz_set_oz_limbs(fmpz_t rop, const mp_limb_t *a, const size_t L) {
+  size_t s = L;
+  while (s > 0 && a[s-1] == 0)
+    s--;
+  if (s <= 1) {
+    fmpz_set_ui(rop, s ? a[0] : 0);
+    return;
+  }
+  __mpz_struct *z = _fmpz_promote(rop);
+  mpn_copyi(mpz_limbs_write(z, s), a, s);
+  mpz_limbs_finish(z, s);
+}
+
+void fmpz_mod_poly_oz_limb_set_fmpz_mod_poly(fmpz_mod_poly_oz_limb_t rop, const fmpz_mod_poly_t op) {
+  const size_t len = fmpz_mod_poly_length(op);
+  assert(len <= rop->n);
+  for(size_t i=0; i<len; i++)
+    fmpz_get_oz_limbs(rop->coeffs + i*rop->L, op->coeffs + i, rop->L);
+  if (len < rop->n)
+    mpn_zero(rop->coeffs + len*rop->L, (rop->n - len)*rop->L);
+}
+
+void fmpz_mod_poly_oz_limb_get_fmpz_mod_poly(fmpz_mod_poly_t rop, const fmpz_mod_poly_oz_limb_t op) {
+  fmpz_mod_poly_fit_length(rop, op->n);
+  for(size_t i=0; i<op->n; i++)
+    fmpz_set_oz_limbs(rop->coeffs + i, op->coeffs + i*op->L, op->L);
+  _fmpz_mod_poly_set_length(rop, op->n);
+  _fmpz_mod_poly_normalise(rop);
+}
+
+int _fmpz_vec_oz_limb_write(FILE *fp, const mp_limb_t *op, const size_t len) {
+  if (oz_limb_is_native())
+    return fwrite(op, sizeof(mp_limb_t), len, fp) != len;
+
+  unsigned char buf[8];
+  for(size_t i=0; i<len; i++) {
+    const uint64_t v = op[i];
+    for(int j=0; j<8; j++)
+      buf[j] = (v>>(8*j)) & 0xff;
+    if (fwrite(buf, 1, 8, fp) != 8)
+      return 1;
+  }
+  return 0;
+}
+
+int fmpz_oz_limb_write(FILE *fp, const fmpz_t op, const size_t L) {
+  mp_limb_t *t = (mp_limb_t*)calloc(L, sizeof(mp_limb_t));
+  fmpz_get_oz_limbs(t, op, L);
+  const int r = _fmpz_vec_oz_limb_write(fp, t, L);
+  free(t);
+  return r;
+}
+
+int fmpz_mod_poly_oz_limb_write(FILE *fp, const fmpz_mod_poly_t op, const size_t n, const size_t L) {
+  const size_t len = fmpz_mod_poly_length(op);
+  assert(len <= n);
+  mp_limb_t *t = (mp_limb_t*)calloc(L, sizeof(mp_limb_t));
+  int r = 0;
+  for(size_t i=0; i<n && !r; i++) {
+    if (i < len)
+      fmpz_get_oz_limbs(t, op->coeffs + i, L);
+    else
+      mpn_zero(t, L);
+    r = _fmpz_vec_oz_limb_write(fp, t, L);
+  }
+  free(t);
+  return r;
+}
+
+void _fmpz_oz_limb_reduce_barrett(mp_limb_t *r, const mp_limb_t *a, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch) {
+  const size_t L = ctx->L;
+  mp_limb_t *q2 = scratch;              // 2L+2 limbs
+  mp_limb_t *qq = q2 + 2*L + 2;         // 2L+1 limbs
+  mp_limb_t *t  = qq + 2*L + 1;         // L+1 limbs
+
+  /* q̂ = ⌊⌊a/B^{L-1}⌋·μ/B^{L+1}⌋ underestimates ⌊a/q⌋ by at most 2 */
+  mpn_mul_n(q2, a + L - 1, ctx->mu, L + 1);
+  mpn_mul(qq, q2 + L + 1, L + 1, ctx->q, L);
+
+  /* a - q̂·q < 3q < B^{L+1} so it suffices to compute it modulo B^{L+1} */
+  mpn_sub_n(t, a, qq, L + 1);
+  while (t[L] || mpn_cmp(t, ctx->q, L) >= 0)
+    t[L] -= mpn_sub_n(t, t, ctx->q, L);
+  mpn_copyi(r, t, L);
+}
+
+void _fmpz_oz_limb_reduce_special(mp_limb_t *r, const mp_limb_t *a, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch) {
+  const size_t L = ctx->L, dn = ctx->dn;
+  const size_t kl = ctx->k/FLINT_BITS;
+  const unsigned int kb = ctx->k%FLINT_BITS;
+  mp_limb_t *x = scratch;                  // 2L+dn+2 limbs
+  mp_limb_t *y = x + 2*L + dn + 2;         // 2L+dn+2 limbs
+  mp_limb_t *hi = y + 2*L + dn + 2;        // 2L limbs
+
+  /* x = hi·2^k + lo ≡ hi·d + lo, each round shrinks x by about k - 64·dn bits */
+  size_t xn = 2*L;
+  mpn_copyi(x, a, xn);
+  while (1) {
+    while (xn > 0 && x[xn-1] == 0)
+      xn--;
+    if (xn < L || (xn == L && (kb == 0 || (x[L-1] >> kb) == 0)))
+      break;
+    const size_t hn = xn - kl;
+    if (kb) {
+      mpn_rshift(hi, x + kl, hn, kb);
+      x[kl] &= (((mp_limb_t)1) << kb) - 1;
+    } else {
+      mpn_copyi(hi, x + kl, hn);
+    }
+    size_t yn = hn + dn;
+    if (hn >= dn)
+      mpn_mul(y, hi, hn, ctx->d, dn);
+    else
+      mpn_mul(y, ctx->d, dn, hi, hn);
+    if (yn < L) {
+      mpn_zero(y + yn, L - yn);
+      yn = L;
+    }
+    y[yn] = mpn_add(y, y, yn, x, L);
+    xn = yn + 1;
+    mp_limb_t *t = x;  x = y;  y = t;
+  }
+  if (xn < L)
+    mpn_zero(x + xn, L - xn);
+  if (mpn_cmp(x, ctx->q, L) >= 0)
+    mpn_sub_n(x, x, ctx->q, L);
+  mpn_copyi(r, x, L);
+}
+
+/**
+   Set `prod` to $a·b$ as $2L$ limbs.
+*/
+
+static inline void _fmpz_oz_limb_mul(mp_limb_t *prod, const mp_limb_t *a, const mp_limb_t *b, const size_t L) {
+  if (L == 1) {
+    umul_ppmm(prod[1], prod[0], a[0], b[0]);
+  } else if (a == b) {
+    mpn_sqr(prod, a, L);
+  } else {
+    mpn_mul_n(prod, a, b, L);
+  }
+}
+
+void _fmpz_oz_limb_mulmod(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch) {
+  _fmpz_oz_limb_mul(scratch, a, b, ctx->L);
+  _fmpz_oz_limb_reduce(r, scratch, ctx, scratch + 2*ctx->L);
+}
+
+void fmpz_oz_limb_mulmod(fmpz_t r, const fmpz_t a, const fmpz_t b, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch) {
+  const size_t L = ctx->L;
+  mp_limb_t *al = scratch, *bl = scratch + L, *rl = scratch + 2*L;
+  fmpz_get_oz_limbs(al, a, L);
+  if (a == b)
+    bl = al;
+  else
+    fmpz_get_oz_limbs(bl, b, L);
+  _fmpz_oz_limb_mulmod(rl, al, bl, ctx, scratch + 3*L);
+  fmpz_set_oz_limbs(r, rl, L);
+}
+
+void _fmpz_oz_limb_redc(mp_limb_t *r, mp_limb_t *t, const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(ctx->qinv);
+  const size_t L = ctx->L;
+  /* clear one limb at a time by adding a multiple of q, t + m·q < 2qR fits into 2L+1 limbs */
+  for(size_t i=0; i<L; i++) {
+    const mp_limb_t m = t[i]*ctx->qinv;
+    const mp_limb_t c = mpn_addmul_1(t + i, ctx->q, L, m);
+    mpn_add_1(t + i + L, t + i + L, L + 1 - i, c);
+  }
+  if (t[2*L] || mpn_cmp(t + L, ctx->q, L) >= 0)
+    mpn_sub_n(t + L, t + L, ctx->q, L);
+  mpn_copyi(r, t + L, L);
+}
+
+void _fmpz_oz_limb_mulmod_mont(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch) {
+  const size_t L = ctx->L;
+  _fmpz_oz_limb_mul(scratch, a, b, L);
+  scratch[2*L] = 0;
+  _fmpz_oz_limb_redc(r, scratch, ctx);
+}
+
+void fmpz_mod_poly_oz_limb_mul(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                               const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(f->n == g->n && h->n == f->n);
+  assert(f->L == ctx->L && g->L == ctx->L && h->L == ctx->L);
+  const size_t L = ctx->L;
+  const size_t n = f->n;
+
+  const int num_threads = ctx->num_threads;
+#pragma omp parallel num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+  {
+    mp_limb_t *scratch = (mp_limb_t*)calloc(OZ_LIMB_MULMOD_SCRATCH(L), sizeof(mp_limb_t));
+#pragma omp for schedule(static)
+    for(size_t i=0; i<n; i++)
+      _fmpz_oz_limb_mulmod(h->coeffs + i*L, f->coeffs + i*L, g->coeffs + i*L, ctx, scratch);
+    free(scratch);
+  }
+}
+
+void fmpz_mod_poly_oz_limb_add(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                               const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(f->n == g->n && h->n == f->n);
+  const size_t L = ctx->L;
+  for(size_t i=0; i<f->n; i++)
+    _fmpz_oz_limb_addmod(h->coeffs + i*L, f->coeffs + i*L, g->coeffs + i*L, ctx);
+}
+
+void fmpz_mod_poly_oz_limb_sub(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                               const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(f->n == g->n && h->n == f->n);
+  const size_t L = ctx->L;
+  for(size_t i=0; i<f->n; i++)
+    _fmpz_oz_limb_submod(h->coeffs + i*L, f->coeffs + i*L, g->coeffs + i*L, ctx);
+}
+
+void fmpz_mod_poly_oz_limb_addmul(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                                  const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(f->n == g->n && h->n == f->n);
+  const size_t L = ctx->L;
+  const size_t n = f->n;
+
+  const int num_threads = ctx->num_threads;
+#pragma omp parallel num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+  {
+    /* f_i·g_i + h_i < q^2 + q < B^{2L} fits into 2L limbs */
+    mp_limb_t *prod = (mp_limb_t*)calloc(2*L + OZ_LIMB_REDUCE_SCRATCH(L), sizeof(mp_limb_t));
+    mp_limb_t *scratch = prod + 2*L;
+#pragma omp for schedule(static)
+    for(size_t i=0; i<n; i++) {
+      mp_limb_t *hi = h->coeffs + i*L;
+      _fmpz_oz_limb_mul(prod, f->coeffs + i*L, g->coeffs + i*L, L);
+      mpn_add(prod, prod, 2*L, hi, L);
+      _fmpz_oz_limb_reduce(hi, prod, ctx, scratch);
+    }
+    free(prod);
+  }
+}
+
+void fmpz_mod_poly_oz_limb_set_fmpz_vec(fmpz_mod_poly_oz_limb_t rop, const fmpz *op, const size_t len,
+                                        const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(len <= rop->n);
+  fmpz_t q;  fmpz_init(q);
+  fmpz_set_oz_limbs(q, ctx->q, ctx->L);
+  fmpz_t t;  fmpz_init(t);
+  for(size_t i=0; i<len; i++) {
+    fmpz_mod(t, op + i, q);
+    fmpz_get_oz_limbs(rop->coeffs + i*rop->L, t, rop->L);
+  }
+  if (len < rop->n)
+    mpn_zero(rop->coeffs + len*rop->L, (rop->n - len)*rop->L);
+  fmpz_clear(t);
+  fmpz_clear(q);
+}
+
+void fmpz_mod_poly_oz_limb_to_mont(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(h->n == f->n);
+  const size_t L = ctx->L;
+  const size_t n = f->n;
+
+  const int num_threads = ctx->num_threads;
+#pragma omp parallel num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+  {
+    mp_limb_t *scratch = (mp_limb_t*)calloc(OZ_LIMB_MULMOD_SCRATCH(L), sizeof(mp_limb_t));
+#pragma omp for schedule(static)
+    for(size_t i=0; i<n; i++)
+      _fmpz_oz_limb_mulmod_mont(h->coeffs + i*L, f->coeffs + i*L, ctx->r2, ctx, scratch);
+    free(scratch);
+  }
+}
+
+void fmpz_mod_poly_oz_limb_from_mont(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(h->n == f->n);
+  const size_t L = ctx->L;
+  const size_t n = f->n;
+
+  const int num_threads = ctx->num_threads;
+#pragma omp parallel num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+  {
+    mp_limb_t *t = (mp_limb_t*)calloc(2*L + 1, sizeof(mp_limb_t));
+#pragma omp for schedule(static)
+    for(size_t i=0; i<n; i++) {
+      mpn_copyi(t, f->coeffs + i*L, L);
+      mpn_zero(t + L, L + 1);
+      _fmpz_oz_limb_redc(h->coeffs + i*L, t, ctx);
+    }
+    free(t);
+  }
+}
+
+void fmpz_mod_poly_oz_limb_mul_mont(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                                    const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(f->n == g->n && h->n == f->n);
+  const size_t L = ctx->L;
+  const size_t n = f->n;
+
+  const int num_threads = ctx->num_threads;
+#pragma omp parallel num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+  {
+    mp_limb_t *scratch = (mp_limb_t*)calloc(OZ_LIMB_MULMOD_SCRATCH(L), sizeof(mp_limb_t));
+#pragma omp for schedule(static)
+    for(size_t i=0; i<n; i++)
+      _fmpz_oz_limb_mulmod_mont(h->coeffs + i*L, f->coeffs + i*L, g->coeffs + i*L, ctx, scratch);
+    free(scratch);
+  }
+}
+
+void fmpz_mod_poly_oz_limb_ntt_ct(fmpz_mod_poly_oz_limb_t a, const fmpz_mod_poly_oz_limb_t phi_br, const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(a->n == phi_br->n);
+  const size_t L = ctx->L;
+  const size_t n = a->n;
+  mp_limb_t *scratch = (mp_limb_t*)calloc(OZ_LIMB_MULMOD_SCRATCH(L) + L, sizeof(mp_limb_t));
+  mp_limb_t *t = scratch + OZ_LIMB_MULMOD_SCRATCH(L);
+
+  /* (x,y) ← (x + s·y, x - s·y) */
+  for(size_t m=1, h=n/2; m<n; m<<=1, h>>=1) {
+    for(size_t i=0; i<m; i++) {
+      const mp_limb_t *s = phi_br->coeffs + (m+i)*L;
+      mp_limb_t *x = a->coeffs + 2*i*h*L;
+      for(size_t j=0; j<h; j++) {
+        mp_limb_t *xj = x + j*L, *yj = x + (j+h)*L;
+        _fmpz_oz_limb_mulmod(t, yj, s, ctx, scratch);
+        _fmpz_oz_limb_submod(yj, xj, t, ctx);
+        _fmpz_oz_limb_addmod(xj, xj, t, ctx);
+      }
+    }
+  }
+  free(scratch);
+}
+
+void fmpz_mod_poly_oz_limb_ntt_gs(fmpz_mod_poly_oz_limb_t a, const fmpz_mod_poly_oz_limb_t phi_inv_br, const mp_limb_t *n_inv,
+                                  const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(a->n == phi_inv_br->n);
+  const size_t L = ctx->L;
+  const size_t n = a->n;
+  mp_limb_t *scratch = (mp_limb_t*)calloc(OZ_LIMB_MULMOD_SCRATCH(L) + L, sizeof(mp_limb_t));
+  mp_limb_t *t = scratch + OZ_LIMB_MULMOD_SCRATCH(L);
+
+  /* (x,y) ← (c·(x + y), s·(x - y)), c = n^{-1} in the last stage and 1 otherwise */
+  for(size_t m=n/2, h=1; m>0; m>>=1, h<<=1) {
+    for(size_t i=0; i<m; i++) {
+      const mp_limb_t *s = phi_inv_br->coeffs + (m+i)*L;
+      mp_limb_t *x = a->coeffs + 2*i*h*L;
+      for(size_t j=0; j<h; j++) {
+        mp_limb_t *xj = x + j*L, *yj = x + (j+h)*L;
+        _fmpz_oz_limb_submod(t, xj, yj, ctx);
+        _fmpz_oz_limb_addmod(xj, xj, yj, ctx);
+        if (m == 1)
+          _fmpz_oz_limb_mulmod(xj, xj, n_inv, ctx, scratch);
+        _fmpz_oz_limb_mulmod(yj, t, s, ctx, scratch);
+      }
+    }
+  }
+  free(scratch);
+}
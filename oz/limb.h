@@ -0,0 +1,427 @@
+/**
+   @file limb.h
+   @brief Elements of @f$\ZZ_q[x]/\ideal{x^n+1}@f$ as fixed-width limb arrays.
+
+   Let $L = \lceil \log_2 q / 64 \rceil$. An element is stored as one contiguous array of $n·L$
+   limbs where coefficient $i$ occupies limbs $i·L,…,i·L+L-1$, least significant limb first, and is
+   always fully reduced, i.e. in $[0,q)$. On little-endian hosts with 64-bit limbs this is also the
+   on-disk layout, so arrays written by `_fmpz_vec_oz_limb_write()` can be `mmap`ed and used in
+   place.
+
+   A `fmpz_mod_poly_oz_limb_t` is either a view on memory it does not own, set up by
+   `fmpz_mod_poly_oz_limb_view()`, or owns its limbs if it was set up by
+   `fmpz_mod_poly_oz_limb_init()`. All kernels work on both and only call `mpn` functions, so they
+   run unchanged on read-only mapped memory and per-coefficient kernels never touch the heap.
+
+   Products are reduced by Barrett reduction with $μ = \lfloor 2^{128L}/q \rfloor$ stored in the
+   context, so reducing costs two `mpn` multiplications and no division. For odd $q$ the context also
+   holds the word inverse $-q^{-1} \bmod 2^{64}$ and $R^2 \bmod q$ where $R = 2^{64L}$, which
+   `_fmpz_oz_limb_mulmod_mont()` and friends use for arithmetic on elements in Montgomery form $aR
+   \bmod q$.
+
+   If $q = 2^k - d$ for some short $d$, e.g. $q = 2^k - c·2n + 1$ as produced by
+   `fmpz_mod_poly_oz_special_modulus()`, products are instead reduced by folding $2^k ≡ d$, which
+   costs $O(L)$ word multiplications rather than $O(L^2)$.
+*/
+
+#ifndef LIMB_H
+#define LIMB_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <gmp.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fmpz_mod_poly.h>
+
+/**
+   @brief $q = 2^k - d$ is reduced by folding if $d$ has at most $L$ / `OZ_LIMB_SPECIAL_FACTOR` limbs.
+*/
+
+#ifndef OZ_LIMB_SPECIAL_FACTOR
+#define OZ_LIMB_SPECIAL_FACTOR 8
+#endif
+
+/**
+   @brief Modulus $q$ as a limb array with reduction constants.
+*/
+
+struct fmpz_mod_oz_limb_ctx_struct {
+  size_t L;                   //!< number of limbs of $q$
+  mp_limb_t *q;               //!< $q$ as $L$ limbs
+  mp_limb_t *mu;              //!< Barrett constant $\lfloor 2^{128L}/q \rfloor$ as $L+1$ limbs
+  mp_limb_t *r2;              //!< $R^2 \bmod q$ as $L$ limbs where $R = 2^{64L}$
+  mp_limb_t qinv;             //!< $-q^{-1} \bmod 2^{64}$ or 0 if $q$ is even
+  size_t k;                   //!< bit length of $q$
+  size_t dn;                  //!< number of limbs of $d = 2^k - q$ if $q$ has special form, 0 otherwise
+  mp_limb_t *d;               //!< $d = 2^k - q$ as `dn` limbs or `NULL`
+  int num_threads;            //!< number of OpenMP threads used by pointwise operations on ≥ `OZ_NTT_PARALLEL_THRESHOLD` coefficients
+};
+
+/**
+   @brief Modulus $q$ as a limb array with reduction constants.
+*/
+
+typedef struct fmpz_mod_oz_limb_ctx_struct fmpz_mod_oz_limb_ctx_t[1];
+
+/**
+   @brief $n$ coefficients of $L$ limbs each in one contiguous array.
+*/
+
+struct fmpz_mod_poly_oz_limb_struct {
+  mp_limb_t *coeffs;          //!< coefficient $i$ at limbs $i·L,…,i·L+L-1$
+  size_t n;                   //!< number of coefficients
+  size_t L;                   //!< limbs per coefficient
+};
+
+/**
+   @brief $n$ coefficients of $L$ limbs each in one contiguous array.
+*/
+
+typedef struct fmpz_mod_poly_oz_limb_struct fmpz_mod_poly_oz_limb_t[1];
+
+/**
+   @brief Return $\lceil \log_2 q / 64 \rceil$, the number of limbs per coefficient modulo $q$.
+*/
+
+static inline size_t fmpz_oz_limb_width(const fmpz_t q) {
+  return (fmpz_sizeinbase(q, 2) + FLINT_BITS - 1)/FLINT_BITS;
+}
+
+/**
+   @brief Return 1 if limb arrays in memory agree with the on-disk layout, i.e. limbs are 64-bit
+   little-endian words.
+*/
+
+static inline int oz_limb_is_native(void) {
+  const uint64_t one = 1;
+  return (FLINT_BITS == 64) && (*(const unsigned char *)&one == 1);
+}
+
+/**
+   @brief Let `op` point to `coeffs` holding $n$ coefficients of $L$ limbs each.
+*/
+
+static inline void fmpz_mod_poly_oz_limb_view(fmpz_mod_poly_oz_limb_t op, const mp_limb_t *coeffs, const size_t n, const size_t L) {
+  op->coeffs = (mp_limb_t *)coeffs;
+  op->n = n;
+  op->L = L;
+}
+
+/**
+   @brief Initialise `op` to $n$ zero coefficients modulo $q$, owning one contiguous array of $n·L$ limbs.
+*/
+
+void fmpz_mod_poly_oz_limb_init(fmpz_mod_poly_oz_limb_t op, const size_t n, const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Clear `op` which was initialised with `fmpz_mod_poly_oz_limb_init()`.
+*/
+
+void fmpz_mod_poly_oz_limb_clear(fmpz_mod_poly_oz_limb_t op);
+
+/**
+   @brief Set `op` to zero.
+*/
+
+static inline void fmpz_mod_poly_oz_limb_zero(fmpz_mod_poly_oz_limb_t op) {
+  mpn_zero(op->coeffs, op->n*op->L);
+}
+
+/**
+   @brief Set `rop` to `op`, both must have the same dimensions.
+*/
+
+static inline void fmpz_mod_poly_oz_limb_set(fmpz_mod_poly_oz_limb_t rop, const fmpz_mod_poly_oz_limb_t op) {
+  if (rop->coeffs != op->coeffs)
+    mpn_copyi(rop->coeffs, op->coeffs, op->n*op->L);
+}
+
+/**
+   @brief Initialise `ctx` for $q$, computing the Barrett and Montgomery constants.
+
+   `ctx->num_threads` is read once from `fmpz_mod_poly_oz_ntt_num_threads()` here, so that
+   pointwise operations with `ctx` do not query the environment.
+*/
+
+void fmpz_mod_oz_limb_ctx_init(fmpz_mod_oz_limb_ctx_t ctx, const fmpz_t q);
+
+/**
+   @brief Initialise `ctx` from $q$ given as $L$ limbs (copied).
+*/
+
+void fmpz_mod_oz_limb_ctx_init_mpn(fmpz_mod_oz_limb_ctx_t ctx, const mp_limb_t *q, const size_t L);
+
+/**
+   @brief Clear `ctx`.
+*/
+
+void fmpz_mod_oz_limb_ctx_clear(fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Set $q$ to the smallest prime of the form $2^k - c·2n + 1$ with $c ≥ 1$.
+
+   Such $q$ satisfy $q ≡ 1 \bmod 2n$, so $\ZZ_q$ has the $2n$-th roots of unity required by the
+   negacyclic NTT, and have the special form $2^k - d$ with short $d = c·2n - 1$.
+
+   @param q  return value
+   @param n  power of two
+   @param k  bit length of $q$, large enough that $c·2n < 2^{k-1}$
+*/
+
+void fmpz_mod_poly_oz_special_modulus(fmpz_t q, const size_t n, const mp_bitcnt_t k);
+
+/**
+   @brief Write $0 ≤ a < 2^{64L}$ to `rop` as $L$ limbs.
+*/
+
+void fmpz_get_oz_limbs(mp_limb_t *rop, const fmpz_t a, const size_t L);
+
+/**
+   @brief Set `rop` to the integer given by $L$ limbs.
+*/
+
+void fmpz_set_oz_limbs(fmpz_t rop, const mp_limb_t *a, const size_t L);
+
+/**
+   @brief Write the coefficients of `op` to the view `rop`, padding with zeros up to `rop->n`.
+
+   @param rop  view on writable memory
+   @param op   polynomial of length at most `rop->n` with coefficients in $[0,q)$
+*/
+
+void fmpz_mod_poly_oz_limb_set_fmpz_mod_poly(fmpz_mod_poly_oz_limb_t rop, const fmpz_mod_poly_t op);
+
+/**
+   @brief Set `rop` to the coefficients in the view `op`.
+*/
+
+void fmpz_mod_poly_oz_limb_get_fmpz_mod_poly(fmpz_mod_poly_t rop, const fmpz_mod_poly_oz_limb_t op);
+
+/**
+   @brief Write $n·L$ limbs to `fp` as 64-bit little-endian words.
+
+   @return 0 on success, 1 if writing failed
+*/
+
+int _fmpz_vec_oz_limb_write(FILE *fp, const mp_limb_t *op, const size_t len);
+
+/**
+   @brief Write `op` to `fp` as $L$ 64-bit little-endian words.
+
+   @return 0 on success, 1 if writing failed
+*/
+
+int fmpz_oz_limb_write(FILE *fp, const fmpz_t op, const size_t L);
+
+/**
+   @brief Write `op` to `fp` as $n·L$ 64-bit little-endian words, padding with zeros up to $n$.
+
+   @return 0 on success, 1 if writing failed
+*/
+
+int fmpz_mod_poly_oz_limb_write(FILE *fp, const fmpz_mod_poly_t op, const size_t n, const size_t L);
+
+/**
+   @brief Compute $r = a + b \\bmod q$ for $a, b \\in [0,q)$, `r` may alias `a` or `b`.
+*/
+
+static inline void _fmpz_oz_limb_addmod(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b, const fmpz_mod_oz_limb_ctx_t ctx) {
+  const mp_limb_t c = mpn_add_n(r, a, b, ctx->L);
+  if (c || mpn_cmp(r, ctx->q, ctx->L) >= 0)
+    mpn_sub_n(r, r, ctx->q, ctx->L);
+}
+
+/**
+   @brief Compute $r = a - b \\bmod q$ for $a, b \\in [0,q)$, `r` may alias `a` or `b`.
+*/
+
+static inline void _fmpz_oz_limb_submod(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b, const fmpz_mod_oz_limb_ctx_t ctx) {
+  if (mpn_sub_n(r, a, b, ctx->L))
+    mpn_add_n(r, r, ctx->q, ctx->L);
+}
+
+/**
+   @brief Return 1 if $q$ has the special form $2^k - d$ with short $d$.
+*/
+
+static inline int fmpz_mod_oz_limb_ctx_is_special(const fmpz_mod_oz_limb_ctx_t ctx) {
+  return ctx->dn != 0;
+}
+
+/**
+   @brief Return 1 if multiplying by a fixed factor is fastest in Montgomery form, i.e. if $q$ is odd
+   and has no special form.
+*/
+
+static inline int fmpz_mod_oz_limb_ctx_prefers_mont(const fmpz_mod_oz_limb_ctx_t ctx) {
+  return ctx->qinv && !ctx->dn;
+}
+
+/**
+   @brief Number of scratch limbs required by `_fmpz_oz_limb_reduce()`.
+*/
+
+#define OZ_LIMB_REDUCE_SCRATCH(L) (8*(L)+4)
+
+/**
+   @brief Compute $r = a \bmod q$ for $a$ of $2L$ limbs by Barrett reduction.
+
+   @param scratch  at least `OZ_LIMB_REDUCE_SCRATCH(L)` limbs
+*/
+
+void _fmpz_oz_limb_reduce_barrett(mp_limb_t *r, const mp_limb_t *a, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch);
+
+/**
+   @brief Compute $r = a \bmod q$ for $a$ of $2L$ limbs and $q = 2^k - d$ of special form.
+
+   @param scratch  at least `OZ_LIMB_REDUCE_SCRATCH(L)` limbs
+*/
+
+void _fmpz_oz_limb_reduce_special(mp_limb_t *r, const mp_limb_t *a, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch);
+
+/**
+   @brief Compute $r = a \bmod q$ for $a$ of $2L$ limbs, exploiting the form of $q$ if possible.
+
+   @param scratch  at least `OZ_LIMB_REDUCE_SCRATCH(L)` limbs
+*/
+
+static inline void _fmpz_oz_limb_reduce(mp_limb_t *r, const mp_limb_t *a, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch) {
+  if (ctx->dn)
+    _fmpz_oz_limb_reduce_special(r, a, ctx, scratch);
+  else
+    _fmpz_oz_limb_reduce_barrett(r, a, ctx, scratch);
+}
+
+/**
+   @brief Number of scratch limbs required by `_fmpz_oz_limb_mulmod()` and `_fmpz_oz_limb_mulmod_mont()`.
+*/
+
+#define OZ_LIMB_MULMOD_SCRATCH(L) (2*(L) + OZ_LIMB_REDUCE_SCRATCH(L))
+
+/**
+   @brief Compute $r = a·b \bmod q$ for $a, b \in [0,q)$, `r` may alias `a` or `b`.
+
+   @param scratch  at least `OZ_LIMB_MULMOD_SCRATCH(L)` limbs
+*/
+
+void _fmpz_oz_limb_mulmod(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch);
+
+/**
+   @brief Number of scratch limbs required by `fmpz_oz_limb_mulmod()`.
+*/
+
+#define OZ_LIMB_FMPZ_MULMOD_SCRATCH(L) (3*(L) + OZ_LIMB_MULMOD_SCRATCH(L))
+
+/**
+   @brief Compute $r = a·b \bmod q$ for $a, b \in [0,q)$ via `_fmpz_oz_limb_mulmod()`, `r` may alias `a` or `b`.
+
+   @param scratch  at least `OZ_LIMB_FMPZ_MULMOD_SCRATCH(L)` limbs
+*/
+
+void fmpz_oz_limb_mulmod(fmpz_t r, const fmpz_t a, const fmpz_t b, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch);
+
+/**
+   @brief Compute $r = t R^{-1} \bmod q$ for $t < qR$ of $2L+1$ limbs, destroying $t$.
+
+   Requires $q$ to be odd.
+*/
+
+void _fmpz_oz_limb_redc(mp_limb_t *r, mp_limb_t *t, const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Compute $r = a·b·R^{-1} \bmod q$ for $a, b \in [0,q)$, `r` may alias `a` or `b`.
+
+   If $a$ and $b$ are in Montgomery form so is $r$. Requires $q$ to be odd.
+
+   @param scratch  at least `OZ_LIMB_MULMOD_SCRATCH(L)` limbs
+*/
+
+void _fmpz_oz_limb_mulmod_mont(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b, const fmpz_mod_oz_limb_ctx_t ctx, mp_limb_t *scratch);
+
+/**
+   @brief Compute $h = f ⊙ g$ coefficient-wise, `h` may alias `f` or `g`.
+*/
+
+void fmpz_mod_poly_oz_limb_mul(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                               const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Compute $h = f + g$ coefficient-wise, `h` may alias `f` or `g`.
+*/
+
+void fmpz_mod_poly_oz_limb_add(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                               const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Compute $h = f - g$ coefficient-wise, `h` may alias `f` or `g`.
+*/
+
+void fmpz_mod_poly_oz_limb_sub(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                               const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Compute $h = h + f ⊙ g$ coefficient-wise with a single reduction per coefficient.
+*/
+
+void fmpz_mod_poly_oz_limb_addmul(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                                  const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Set `rop` to the coefficients of `op` reduced modulo $q$, padding with zeros up to `rop->n`.
+
+   Unlike `fmpz_mod_poly_oz_limb_set_fmpz_mod_poly()` the coefficients of `op` may be negative or
+   exceed $q$.
+*/
+
+void fmpz_mod_poly_oz_limb_set_fmpz_vec(fmpz_mod_poly_oz_limb_t rop, const fmpz *op, const size_t len,
+                                        const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Set $h_i = f_i R \bmod q$, i.e. convert `f` to Montgomery form, `h` may alias `f`.
+*/
+
+void fmpz_mod_poly_oz_limb_to_mont(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Set $h_i = f_i R^{-1} \bmod q$, i.e. convert `f` from Montgomery form, `h` may alias `f`.
+*/
+
+void fmpz_mod_poly_oz_limb_from_mont(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Compute $h = f ⊙ g$ coefficient-wise for `f` and `g` in Montgomery form, `h` may alias `f` or `g`.
+
+   Addition and subtraction do not depend on the representation, so `fmpz_mod_poly_oz_limb_add()`
+   and `fmpz_mod_poly_oz_limb_sub()` apply unchanged.
+*/
+
+void fmpz_mod_poly_oz_limb_mul_mont(fmpz_mod_poly_oz_limb_t h, const fmpz_mod_poly_oz_limb_t f, const fmpz_mod_poly_oz_limb_t g,
+                                    const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief In-place negacyclic Cooley-Tukey transform on limbs, output in bit-reversed order.
+
+   @param a       view on writable memory
+   @param phi_br  twiddle factors as in `fmpz_mod_poly_oz_ntt_precomp_t`
+
+   @see _fmpz_vec_oz_ntt_ct
+*/
+
+void fmpz_mod_poly_oz_limb_ntt_ct(fmpz_mod_poly_oz_limb_t a, const fmpz_mod_poly_oz_limb_t phi_br, const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief In-place negacyclic Gentleman-Sande transform on limbs of input in bit-reversed order,
+   scaled by $n^{-1}$.
+
+   @param a           view on writable memory
+   @param phi_inv_br  twiddle factors as in `fmpz_mod_poly_oz_ntt_precomp_t`, with $n^{-1}$ folded into index 1
+   @param n_inv       $n^{-1} \\bmod q$ as $L$ limbs
+
+   @see _fmpz_vec_oz_ntt_gs
+*/
+
+void fmpz_mod_poly_oz_limb_ntt_gs(fmpz_mod_poly_oz_limb_t a, const fmpz_mod_poly_oz_limb_t phi_inv_br, const mp_limb_t *n_inv,
+                                  const fmpz_mod_oz_limb_ctx_t ctx);
+
+#endif /* LIMB_H */
@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <omp.h>
 #include "ntt.h"
 #include "util.h"
 
@@ -62,56 +63,214 @@ static void fmpz_mod_poly_oz_set_powers(fmpz_mod_poly_t op, const size_t n, cons
   fmpz_clear(acc);
 }
 
-void _fmpz_mod_poly_oz_ntt(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_t w, const size_t n) {
-  if (n == 1) {
-    fmpz_mod_poly_set(rop, op);
-    return;
+int fmpz_mod_poly_oz_ntt_num_threads(void) {
+  const char *s = getenv("OZ_NUM_THREADS");
+  if (s) {
+    const int t = atoi(s);
+    if (t > 0)
+      return t;
   }
-  const fmpz *q = fmpz_mod_poly_modulus(op);
-  const size_t k = n_flog(n,2);
+  return omp_get_max_threads();
+}
 
-  fmpz_mod_poly_t a; fmpz_mod_poly_init2(a, q, n);
-  for (size_t i = 0; i < n; i++) {
-    size_t ii = i, r=0;
-    for (size_t h = 0; h < k; h++) {
-      r = (r << 1) | (ii & 1);
-      ii >>= 1;
+/**
+   Cooley-Tukey butterfly $(x,y) ← (x + s·y, x - s·y)$ using temporary `t`.
+*/
+
+static inline void _fmpz_oz_ntt_ct_butterfly(fmpz *x, fmpz *y, const fmpz *s, const fmpz_t q, fmpz *t) {
+  fmpz_mul(t, y, s);
+  fmpz_mod(t, t, q);
+  fmpz_sub(y, x, t);
+  if (fmpz_sgn(y) < 0)
+    fmpz_add(y, y, q);
+  fmpz_add(x, x, t);
+  if (fmpz_cmp(x, q) >= 0)
+    fmpz_sub(x, x, q);
+}
+
+/**
+   Set $r = a·s \bmod q$ for a twiddle factor $s$ as limbs, which is in Montgomery form if
+   `fmpz_mod_oz_limb_ctx_prefers_mont()`.
+*/
+
+static inline void _fmpz_oz_ntt_mul_twiddle(fmpz *r, const fmpz *a, const mp_limb_t *s, struct fmpz_mod_poly_oz_ntt_ws_struct *ws) {
+  const size_t L = ws->ctx->L;
+  mp_limb_t *al = ws->scratch;
+  fmpz_get_oz_limbs(al, a, L);
+  if (fmpz_mod_oz_limb_ctx_prefers_mont(ws->ctx))
+    _fmpz_oz_limb_mulmod_mont(al, al, s, ws->ctx, al + L);
+  else
+    _fmpz_oz_limb_mulmod(al, al, s, ws->ctx, al + L);
+  fmpz_set_oz_limbs(r, al, L);
+}
+
+/**
+   Cooley-Tukey butterfly $(x,y) ← (x + s·y, x - s·y)$ for a twiddle factor as limbs.
+*/
+
+static inline void _fmpz_oz_ntt_ct_butterfly_ws(fmpz *x, fmpz *y, const mp_limb_t *s, const fmpz_t q,
+                                                struct fmpz_mod_poly_oz_ntt_ws_struct *ws) {
+  fmpz *t = ws->t;
+  _fmpz_oz_ntt_mul_twiddle(t, y, s, ws);
+  fmpz_sub(y, x, t);
+  if (fmpz_sgn(y) < 0)
+    fmpz_add(y, y, q);
+  fmpz_add(x, x, t);
+  if (fmpz_cmp(x, q) >= 0)
+    fmpz_sub(x, x, q);
+}
+
+/**
+   Gentleman-Sande butterfly $(x,y) ← (c·(x + y), s·(x - y))$ for twiddle factors as limbs, where $c
+   = 1$ if `c` is `NULL`.
+*/
+
+static inline void _fmpz_oz_ntt_gs_butterfly_ws(fmpz *x, fmpz *y, const mp_limb_t *s, const mp_limb_t *c, const fmpz_t q,
+                                                struct fmpz_mod_poly_oz_ntt_ws_struct *ws) {
+  fmpz *t = ws->t;
+  fmpz_sub(t, x, y);
+  if (fmpz_sgn(t) < 0)
+    fmpz_add(t, t, q);
+  fmpz_add(x, x, y);
+  if (fmpz_cmp(x, q) >= 0)
+    fmpz_sub(x, x, q);
+  if (c)
+    _fmpz_oz_ntt_mul_twiddle(x, x, c, ws);
+  _fmpz_oz_ntt_mul_twiddle(y, t, s, ws);
+}
+
+void _fmpz_vec_oz_ntt_ct(fmpz *a, const mp_limb_t *phi_br, const size_t n, const fmpz_t q, fmpz_mod_poly_oz_ntt_ws_t ws) {
+  const size_t L = ws->ctx->L;
+  for(size_t m=1, h=n/2; m<n; m<<=1, h>>=1) {
+    for(size_t i=0; i<m; i++) {
+      fmpz *x = a + 2*i*h;
+      for(size_t j=0; j<h; j++)
+        _fmpz_oz_ntt_ct_butterfly_ws(x+j, x+j+h, phi_br + (m + i)*L, q, ws);
+    }
+  }
+}
+
+void _fmpz_vec_oz_ntt_gs(fmpz *a, const mp_limb_t *phi_inv_br, const mp_limb_t *n_inv, const size_t n, const fmpz_t q, fmpz_mod_poly_oz_ntt_ws_t ws) {
+  const size_t L = ws->ctx->L;
+  for(size_t m=n/2, h=1; m>0; m>>=1, h<<=1) {
+    /* last stage, phi_inv_br[1] already has 1/n folded in */
+    const mp_limb_t *c = (m == 1) ? n_inv : NULL;
+    for(size_t i=0; i<m; i++) {
+      fmpz *x = a + 2*i*h;
+      for(size_t j=0; j<h; j++)
+        _fmpz_oz_ntt_gs_butterfly_ws(x+j, x+j+h, phi_inv_br + (m + i)*L, c, q, ws);
     }
-    fmpz_set(a->coeffs+r, op->coeffs+i);
   }
-  fmpz_mod_poly_t b; fmpz_mod_poly_init2(b, q, n);
-
-  fmpz *a_hdl = a->coeffs;
-  fmpz *b_hdl = b->coeffs;
-
-  for(size_t i=0; i<k; i++) {
-/* #pragma omp parallel for */
-    for(size_t j=0; j<n/2; j++) {
-      fmpz_t tmp;  fmpz_init(tmp);
-      const size_t tk  = (1UL<<(k-1-i));
-      const size_t pij = (j/tk) * tk;
-      fmpz_mul(tmp, a_hdl + 2*j+1, w->coeffs + pij);
-      if(pij)
-        fmpz_mod(tmp, tmp, q);
-      fmpz_add(b_hdl + j,       a_hdl + 2*j, tmp);
-      if (fmpz_cmpabs(b_hdl + j, q) >= 0)
-        fmpz_sub(b_hdl + j, b_hdl + j, q);
-      fmpz_sub(b_hdl + j + n/2, a_hdl + 2*j, tmp);
-      if (fmpz_sgn(b_hdl + j + n/2) < 0)
-        fmpz_add(b_hdl + j + n/2, b_hdl + j + n/2, q);
-      fmpz_clear(tmp);
+}
+
+/*
+  In the parallel variants each stage is a flat loop over the $n/2$ butterflies, butterfly $b$ is
+  the $(b \bmod h)$-th butterfly of group $\lfloor b/h \rfloor$. Stages are separated by the implicit
+  barrier of `omp for`.
+*/
+
+void _fmpz_vec_oz_ntt_ct_par(fmpz *a, const mp_limb_t *phi_br, const size_t n, const fmpz_t q,
+                             fmpz_mod_poly_oz_ntt_ws_t ws, const int num_threads) {
+  const size_t L = ws->ctx->L;
+#pragma omp parallel num_threads(num_threads)
+  {
+    const int tid = omp_get_thread_num();
+    struct fmpz_mod_poly_oz_ntt_ws_struct *w = (tid == 0) ? ws : ws->team + tid - 1;
+    for(size_t m=1, h=n/2; m<n; m<<=1, h>>=1) {
+#pragma omp for schedule(static)
+      for(size_t b=0; b<n/2; b++) {
+        const size_t i = b/h, j = b%h;
+        fmpz *x = a + 2*i*h;
+        _fmpz_oz_ntt_ct_butterfly_ws(x+j, x+j+h, phi_br + (m + i)*L, q, w);
+      }
     }
-    if(i!=k-1) {
-      fmpz *t = a_hdl;
-      a_hdl = b_hdl;
-      b_hdl = t;
+  }
+}
+
+void _fmpz_vec_oz_ntt_gs_par(fmpz *a, const mp_limb_t *phi_inv_br, const mp_limb_t *n_inv, const size_t n, const fmpz_t q,
+                             fmpz_mod_poly_oz_ntt_ws_t ws, const int num_threads) {
+  const size_t L = ws->ctx->L;
+#pragma omp parallel num_threads(num_threads)
+  {
+    const int tid = omp_get_thread_num();
+    struct fmpz_mod_poly_oz_ntt_ws_struct *w = (tid == 0) ? ws : ws->team + tid - 1;
+    for(size_t m=n/2, h=1; m>0; m>>=1, h<<=1) {
+      const mp_limb_t *c = (m == 1) ? n_inv : NULL;
+#pragma omp for schedule(static)
+      for(size_t b=0; b<n/2; b++) {
+        const size_t i = b/h, j = b%h;
+        fmpz *x = a + 2*i*h;
+        _fmpz_oz_ntt_gs_butterfly_ws(x+j, x+j+h, phi_inv_br + (m + i)*L, c, q, w);
+      }
     }
   }
-  fmpz_mod_poly_realloc(rop, n);
-  _fmpz_vec_set(rop->coeffs, b_hdl, n);
+}
+
+/**
+   Return the number of threads to use for a transform of length $n$ using `precomp` and `ws`,
+   i.e. 1 if we should stay serial.
+*/
+
+static inline int _fmpz_mod_poly_oz_ntt_threads(const fmpz_mod_poly_oz_ntt_precomp_t precomp, const fmpz_mod_poly_oz_ntt_ws_t ws) {
+  if (precomp->n < OZ_NTT_PARALLEL_THRESHOLD || omp_in_parallel())
+    return 1;
+  return (precomp->num_threads < ws->nteam + 1) ? precomp->num_threads : ws->nteam + 1;
+}
+
+static void _fmpz_mod_poly_oz_ntt_precomp_ct(fmpz *a, const fmpz_mod_poly_oz_ntt_precomp_t precomp, fmpz_mod_poly_oz_ntt_ws_t ws) {
+  const fmpz *q = fmpz_mod_poly_modulus(precomp->phi_br);
+  const int num_threads = _fmpz_mod_poly_oz_ntt_threads(precomp, ws);
+  if (num_threads > 1)
+    _fmpz_vec_oz_ntt_ct_par(a, precomp->phi_br_mont, precomp->n, q, ws, num_threads);
+  else
+    _fmpz_vec_oz_ntt_ct(a, precomp->phi_br_mont, precomp->n, q, ws);
+}
+
+static void _fmpz_mod_poly_oz_ntt_precomp_gs(fmpz *a, const fmpz_mod_poly_oz_ntt_precomp_t precomp, fmpz_mod_poly_oz_ntt_ws_t ws) {
+  const fmpz *q = fmpz_mod_poly_modulus(precomp->phi_br);
+  const int num_threads = _fmpz_mod_poly_oz_ntt_threads(precomp, ws);
+  if (num_threads > 1)
+    _fmpz_vec_oz_ntt_gs_par(a, precomp->phi_inv_br_mont, precomp->n_inv_mont, precomp->n, q, ws, num_threads);
+  else
+    _fmpz_vec_oz_ntt_gs(a, precomp->phi_inv_br_mont, precomp->n_inv_mont, precomp->n, q, ws);
+}
+
+void _fmpz_mod_poly_oz_ntt(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_t w, const size_t n) {
+  const fmpz *q = fmpz_mod_poly_modulus(op);
+  const size_t len = fmpz_mod_poly_length(op);
+  assert(len <= n);
+
+  fmpz_mod_poly_set(rop, op);
+  fmpz_mod_poly_fit_length(rop, n);
+  _fmpz_vec_zero(rop->coeffs + len, n - len);
   rop->length = n;
-  fmpz_mod_poly_clear(b);
-  fmpz_mod_poly_clear(a);
+  if (n == 1)
+    return;
+
+  fmpz *a = rop->coeffs;
+  for(size_t i=1, j=0; i<n; i++) {
+    size_t bit = n>>1;
+    for(; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j)
+      fmpz_swap(a+i, a+j);
+  }
+
+  const int num_threads = fmpz_mod_poly_oz_ntt_num_threads();
+#pragma omp parallel num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+  {
+    fmpz_t t;  fmpz_init(t);
+    for(size_t h=1; h<n; h <<= 1) {
+      const size_t step = n/(2*h);
+#pragma omp for schedule(static)
+      for(size_t b=0; b<n/2; b++) {
+        const size_t s = (b/h)*2*h, j = b%h;
+        _fmpz_oz_ntt_ct_butterfly(a+s+j, a+s+j+h, w->coeffs + j*step, q, t);
+      }
+    }
+    fmpz_clear(t);
+  }
 }
 
 void fmpz_mod_poly_oz_ntt(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const size_t n) {
@@ -146,6 +305,78 @@ void fmpz_mod_poly_oz_intt(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const
 }
 
 
+/**
+   Write the twiddle factors `op` as limbs to `rop`, in Montgomery form if `fmpz_mod_oz_limb_ctx_prefers_mont()`.
+*/
+
+static void _fmpz_vec_oz_ntt_twiddles(mp_limb_t *rop, const fmpz *op, const size_t len, const fmpz_mod_oz_limb_ctx_t ctx) {
+  const size_t L = ctx->L;
+  mp_limb_t *scratch = (mp_limb_t*)calloc(OZ_LIMB_MULMOD_SCRATCH(L), sizeof(mp_limb_t));
+  for(size_t i=0; i<len; i++) {
+    fmpz_get_oz_limbs(rop + i*L, op + i, L);
+    if (fmpz_mod_oz_limb_ctx_prefers_mont(ctx))
+      _fmpz_oz_limb_mulmod_mont(rop + i*L, rop + i*L, ctx->r2, ctx, scratch);
+  }
+  free(scratch);
+}
+
+void _fmpz_mod_poly_oz_ntt_precomp_init_phi(fmpz_mod_poly_oz_ntt_precomp_t op, const size_t n, const fmpz_t q, const fmpz_t phi) {
+  op->n = n;
+
+  /* bit-reversal permutation on log n bits */
+  const size_t k = n_flog(n, 2);
+  op->brv = (size_t*)calloc(n, sizeof(size_t));
+  for(size_t i=0; i<n; i++) {
+    size_t ii = i, r = 0;
+    for(size_t h=0; h<k; h++) {
+      r = (r << 1) | (ii & 1);
+      ii >>= 1;
+    }
+    op->brv[i] = r;
+  }
+
+  fmpz_t phi_inv;  fmpz_init(phi_inv);
+  fmpz_invmod(phi_inv, phi, q);
+
+  fmpz_mod_poly_init2(op->phi_br, q, n);
+  fmpz_mod_poly_init2(op->phi_inv_br, q, n);
+
+  fmpz_t acc;      fmpz_init_set_ui(acc, 1);
+  fmpz_t acc_inv;  fmpz_init_set_ui(acc_inv, 1);
+  for(size_t i=0; i<n; i++) {
+    fmpz_set(op->phi_br->coeffs     + op->brv[i], acc);
+    fmpz_set(op->phi_inv_br->coeffs + op->brv[i], acc_inv);
+    fmpz_mul(acc, acc, phi);
+    fmpz_mod(acc, acc, q);
+    fmpz_mul(acc_inv, acc_inv, phi_inv);
+    fmpz_mod(acc_inv, acc_inv, q);
+  }
+  op->phi_br->length = n;
+  op->phi_inv_br->length = n;
+  fmpz_clear(acc);
+  fmpz_clear(acc_inv);
+  fmpz_clear(phi_inv);
+
+  /** @note We fold 1/n into the last Gentleman-Sande stage, which is the only user of index 1 **/
+  fmpz_init_set_ui(op->n_inv, n);
+  fmpz_invmod(op->n_inv, op->n_inv, q);
+  if (n > 1) {
+    fmpz_mul(op->phi_inv_br->coeffs + 1, op->phi_inv_br->coeffs + 1, op->n_inv);
+    fmpz_mod(op->phi_inv_br->coeffs + 1, op->phi_inv_br->coeffs + 1, q);
+  }
+
+  fmpz_mod_oz_limb_ctx_init(op->ctx, q);
+  const size_t L = op->ctx->L;
+  op->phi_br_mont = (mp_limb_t*)calloc(n*L, sizeof(mp_limb_t));
+  op->phi_inv_br_mont = (mp_limb_t*)calloc(n*L, sizeof(mp_limb_t));
+  op->n_inv_mont = (mp_limb_t*)calloc(L, sizeof(mp_limb_t));
+  _fmpz_vec_oz_ntt_twiddles(op->phi_br_mont, op->phi_br->coeffs, n, op->ctx);
+  _fmpz_vec_oz_ntt_twiddles(op->phi_inv_br_mont, op->phi_inv_br->coeffs, n, op->ctx);
+  _fmpz_vec_oz_ntt_twiddles(op->n_inv_mont, op->n_inv, 1, op->ctx);
+
+  op->num_threads = op->ctx->num_threads;
+}
+
 void fmpz_mod_poly_oz_ntt_precomp_init(fmpz_mod_poly_oz_ntt_precomp_t op, const size_t n, const fmpz_t q) {
   fmpz_t w;  fmpz_init(w);
   if (!_fmpz_nth_root(w, n, q)) {
@@ -158,66 +389,194 @@ void fmpz_mod_poly_oz_ntt_precomp_init(fmpz_mod_poly_oz_ntt_precomp_t op, const
     fmpz_clear(phi);
     oz_die("q does not have a 2n-th root of unity");
   }
+  fmpz_clear(w);
 
-  op->n = n;
+  _fmpz_mod_poly_oz_ntt_precomp_init_phi(op, n, q, phi);
+  fmpz_clear(phi);
+}
 
-  fmpz_mod_poly_init2(op->w, q, n);
-  fmpz_mod_poly_oz_set_powers(op->w, n, w);
+void fmpz_mod_poly_oz_ntt_precomp_clear(fmpz_mod_poly_oz_ntt_precomp_t op) {
+  free(op->brv);
+  free(op->n_inv_mont);
+  free(op->phi_inv_br_mont);
+  free(op->phi_br_mont);
+  fmpz_mod_oz_limb_ctx_clear(op->ctx);
+  fmpz_clear(op->n_inv);
+  fmpz_mod_poly_clear(op->phi_br);
+  fmpz_mod_poly_clear(op->phi_inv_br);
+}
 
-  fmpz_invmod(w, w, q);
-  fmpz_mod_poly_init2(op->w_inv, q, n);
-  fmpz_mod_poly_oz_set_powers(op->w_inv, n, w);
-  fmpz_clear(w);
+static void _fmpz_mod_poly_oz_ntt_ws_init(fmpz_mod_poly_oz_ntt_ws_t ws, const fmpz_mod_poly_oz_ntt_precomp_t precomp) {
+  const fmpz *q = fmpz_mod_poly_modulus(precomp->phi_br);
+  /* room for a product of two elements of Z_q */
+  fmpz_init2(ws->t, 2*fmpz_size(q) + 1);
+  ws->ctx = precomp->ctx;
+  ws->scratch = (mp_limb_t*)calloc(OZ_LIMB_FMPZ_MULMOD_SCRATCH(precomp->ctx->L), sizeof(mp_limb_t));
+  ws->nteam = 0;
+  ws->team = NULL;
+}
 
-  fmpz_mod_poly_init2(op->phi, q, n);
-  fmpz_mod_poly_oz_set_powers(op->phi, n, phi);
+void fmpz_mod_poly_oz_ntt_ws_init(fmpz_mod_poly_oz_ntt_ws_t ws, const fmpz_mod_poly_oz_ntt_precomp_t precomp) {
+  _fmpz_mod_poly_oz_ntt_ws_init(ws, precomp);
+  /* inside a parallel region transforms stay serial, see _fmpz_mod_poly_oz_ntt_threads() */
+  if (precomp->n < OZ_NTT_PARALLEL_THRESHOLD || precomp->num_threads <= 1 || omp_in_parallel())
+    return;
+  ws->nteam = precomp->num_threads - 1;
+  ws->team = (struct fmpz_mod_poly_oz_ntt_ws_struct*)calloc(ws->nteam, sizeof(struct fmpz_mod_poly_oz_ntt_ws_struct));
+  for(int i=0; i<ws->nteam; i++)
+    _fmpz_mod_poly_oz_ntt_ws_init(ws->team + i, precomp);
+}
 
-  fmpz_invmod(phi, phi, q);
-  fmpz_mod_poly_init2(op->phi_inv, q, n);
-  fmpz_mod_poly_oz_set_powers(op->phi_inv, n, phi);
-  fmpz_clear(phi);
+void fmpz_mod_poly_oz_ntt_ws_clear(fmpz_mod_poly_oz_ntt_ws_t ws) {
+  for(int i=0; i<ws->nteam; i++)
+    fmpz_mod_poly_oz_ntt_ws_clear(ws->team + i);
+  free(ws->team);
+  free(ws->scratch);
+  fmpz_clear(ws->t);
+}
 
-  /** @note We fold 1/n into φ^-1 **/
-  fmpz_t n_inv;  fmpz_init_set_ui(n_inv, n);
-  fmpz_invmod(n_inv, n_inv, q);
+void fmpz_mod_poly_oz_ntt_mul_ctx(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const fmpz_mod_poly_t g, const size_t n,
+                                  const fmpz_mod_oz_limb_ctx_t ctx) {
+  fmpz_mod_poly_realloc(h, n);
 
-  for(size_t i=0; i<n; i++) {
-    fmpz_mul(op->phi_inv->coeffs+i, n_inv, op->phi_inv->coeffs+i);
-    fmpz_mod(op->phi_inv->coeffs+i, op->phi_inv->coeffs+i, q);
+  const int num_threads = ctx->num_threads;
+#pragma omp parallel num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+  {
+    /* a few limbs per thread, kept on the stack so that pointwise products do not touch the heap */
+    mp_limb_t scratch[OZ_LIMB_FMPZ_MULMOD_SCRATCH(ctx->L)];
+#pragma omp for schedule(static)
+    for(size_t i=0; i<n; i++)
+      fmpz_oz_limb_mulmod(h->coeffs + i, f->coeffs + i, g->coeffs + i, ctx, scratch);
   }
-  fmpz_clear(n_inv);
+  h->length = n;
 }
 
-void fmpz_mod_poly_oz_ntt_precomp_clear(fmpz_mod_poly_oz_ntt_precomp_t op) {
-  fmpz_mod_poly_clear(op->w);
-  fmpz_mod_poly_clear(op->w_inv);
-  fmpz_mod_poly_clear(op->phi);
-  fmpz_mod_poly_clear(op->phi_inv);
+void fmpz_mod_poly_oz_ntt_mul_ws(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const fmpz_mod_poly_t g,
+                                 const fmpz_mod_poly_oz_ntt_precomp_t precomp, fmpz_mod_poly_oz_ntt_ws_t ws) {
+  const size_t n = precomp->n;
+  fmpz_mod_poly_realloc(h, n);
+
+  const int num_threads = _fmpz_mod_poly_oz_ntt_threads(precomp, ws);
+#pragma omp parallel num_threads(num_threads) if(num_threads > 1)
+  {
+    const int tid = omp_get_thread_num();
+    struct fmpz_mod_poly_oz_ntt_ws_struct *w = (tid == 0) ? ws : ws->team + tid - 1;
+#pragma omp for schedule(static)
+    for(size_t i=0; i<n; i++)
+      fmpz_oz_limb_mulmod(h->coeffs + i, f->coeffs + i, g->coeffs + i, precomp->ctx, w->scratch);
+  }
+  h->length = n;
 }
 
 void fmpz_mod_poly_oz_ntt_mul(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const fmpz_mod_poly_t g, const size_t n) {
-  const fmpz *q = fmpz_mod_poly_modulus(f);
-  fmpz_mod_poly_realloc(h, n);
+  fmpz_mod_oz_limb_ctx_t ctx;
+  fmpz_mod_oz_limb_ctx_init(ctx, fmpz_mod_poly_modulus(f));
+  fmpz_mod_poly_oz_ntt_mul_ctx(h, f, g, n, ctx);
+  fmpz_mod_oz_limb_ctx_clear(ctx);
+}
 
-/* #pragma omp parallel for */
-  for(size_t i=0; i<n; i++) {
-    fmpz_mul(h->coeffs + i, f->coeffs + i, g->coeffs + i);
-    fmpz_mod(h->coeffs + i, h->coeffs+i, q);
+/* h_i = f_i^{-1} by Montgomery's trick. The input is split into one block per thread, each block
+   computes its prefix products p_i in parallel, the block totals are combined and inverted with a
+   single fmpz_invmod(), and each block runs the backward pass h_i = p_{i-1}·(f_i⋯f_{hi-1})^{-1} from
+   the inverse of its own total. About 3·len multiplications. Returns 0 without touching h if some
+   f_i is not invertible. `h` may alias `f`. */
+
+static int _fmpz_vec_oz_batch_inv(fmpz *h, const fmpz *f, const size_t len, const fmpz_t q,
+                                  const fmpz_mod_oz_limb_ctx_t ctx) {
+  assert(len > 0);
+  const size_t L = ctx->L;
+  const size_t num_threads = (len >= OZ_NTT_PARALLEL_THRESHOLD) ? ctx->num_threads : 1;
+  const size_t bs = (len + num_threads - 1)/num_threads;
+  const size_t nb = (len + bs - 1)/bs;
+
+  mp_limb_t *a = (mp_limb_t*)calloc(len*L, sizeof(mp_limb_t));
+  mp_limb_t *p = (mp_limb_t*)calloc(len*L, sizeof(mp_limb_t));
+  /* c_b = P_0⋯P_b for block totals P_b, w_b = P_b^{-1} */
+  mp_limb_t *c = (mp_limb_t*)calloc(nb*L, sizeof(mp_limb_t));
+  mp_limb_t *w = (mp_limb_t*)calloc(nb*L, sizeof(mp_limb_t));
+
+#pragma omp parallel for num_threads(nb) if(nb > 1) schedule(static)
+  for(size_t b=0; b<nb; b++) {
+    const size_t lo = b*bs, hi = (lo + bs < len) ? lo + bs : len;
+    mp_limb_t *scratch = (mp_limb_t*)calloc(OZ_LIMB_MULMOD_SCRATCH(L), sizeof(mp_limb_t));
+    for(size_t i=lo; i<hi; i++)
+      fmpz_get_oz_limbs(a + i*L, f + i, L);
+    mpn_copyi(p + lo*L, a + lo*L, L);
+    for(size_t i=lo+1; i<hi; i++)
+      _fmpz_oz_limb_mulmod(p + i*L, p + (i-1)*L, a + i*L, ctx, scratch);
+    free(scratch);
   }
-  h->length = n;
+
+  mp_limb_t *u = (mp_limb_t*)calloc(L + OZ_LIMB_MULMOD_SCRATCH(L), sizeof(mp_limb_t));
+  mp_limb_t *scratch = u + L;
+
+  mpn_copyi(c, p + (bs-1)*L, L);
+  for(size_t b=1; b<nb; b++) {
+    const size_t hi = ((b+1)*bs < len) ? (b+1)*bs : len;
+    _fmpz_oz_limb_mulmod(c + b*L, c + (b-1)*L, p + (hi-1)*L, ctx, scratch);
+  }
+
+  fmpz_t inv;
+  fmpz_init(inv);
+  fmpz_set_oz_limbs(inv, c + (nb-1)*L, L);
+  const int r = fmpz_invmod(inv, inv, q);
+
+  if (r) {
+    fmpz_get_oz_limbs(u, inv, L);
+    for(size_t b=nb-1; b>0; b--) {
+      const size_t hi = ((b+1)*bs < len) ? (b+1)*bs : len;
+      _fmpz_oz_limb_mulmod(w + b*L, u, c + (b-1)*L, ctx, scratch);
+      _fmpz_oz_limb_mulmod(u, u, p + (hi-1)*L, ctx, scratch);
+    }
+    mpn_copyi(w, u, L);
+
+#pragma omp parallel for num_threads(nb) if(nb > 1) schedule(static)
+    for(size_t b=0; b<nb; b++) {
+      const size_t lo = b*bs, hi = (lo + bs < len) ? lo + bs : len;
+      mp_limb_t *t = (mp_limb_t*)calloc(L + OZ_LIMB_MULMOD_SCRATCH(L), sizeof(mp_limb_t));
+      mp_limb_t *ub = w + b*L;
+      for(size_t i=hi-1; i>lo; i--) {
+        _fmpz_oz_limb_mulmod(t, ub, p + (i-1)*L, ctx, t + L);
+        _fmpz_oz_limb_mulmod(ub, ub, a + i*L, ctx, t + L);
+        fmpz_set_oz_limbs(h + i, t, L);
+      }
+      fmpz_set_oz_limbs(h + lo, ub, L);
+      free(t);
+    }
+  }
+
+  fmpz_clear(inv);
+  free(u);
+  free(w);
+  free(c);
+  free(p);
+  free(a);
+  return r;
 }
 
-void fmpz_mod_poly_oz_ntt_inv(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const size_t n) {
+void fmpz_mod_poly_oz_ntt_inv_ctx(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const size_t n,
+                                  const fmpz_mod_oz_limb_ctx_t ctx) {
   const fmpz *q = fmpz_mod_poly_modulus(f);
   fmpz_mod_poly_realloc(h, n);
 
-#pragma omp parallel for
-  for(size_t i=0; i<n; i++) {
-    fmpz_invmod(h->coeffs + i, f->coeffs + i, q);
+  if (!_fmpz_vec_oz_batch_inv(h->coeffs, f->coeffs, n, q, ctx)) {
+    /* some evaluation is zero, invert the others one by one */
+    const int num_threads = ctx->num_threads;
+#pragma omp parallel for num_threads(num_threads) if(n >= OZ_NTT_PARALLEL_THRESHOLD)
+    for(size_t i=0; i<n; i++) {
+      fmpz_invmod(h->coeffs + i, f->coeffs + i, q);
+    }
   }
   h->length = n;
 }
 
+void fmpz_mod_poly_oz_ntt_inv(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const size_t n) {
+  fmpz_mod_oz_limb_ctx_t ctx;
+  fmpz_mod_oz_limb_ctx_init(ctx, fmpz_mod_poly_modulus(f));
+  fmpz_mod_poly_oz_ntt_inv_ctx(h, f, n, ctx);
+  fmpz_mod_oz_limb_ctx_clear(ctx);
+}
+
 void fmpz_mod_poly_oz_ntt_set_ui(fmpz_mod_poly_t op, const unsigned long c, const size_t n) {
   fmpz_mod_poly_realloc(op, n);
   for(size_t i=0; i<n; i++)
@@ -230,58 +589,86 @@ void fmpz_mod_poly_oz_ntt_pow_ui(fmpz_mod_poly_t rop, const fmpz_mod_poly_t f, u
   fmpz_mod_poly_init2(tmp, fmpz_mod_poly_modulus(f), n);
   fmpz_mod_poly_set(tmp, f);
 
+  fmpz_mod_oz_limb_ctx_t ctx;
+  fmpz_mod_oz_limb_ctx_init(ctx, fmpz_mod_poly_modulus(f));
+
   fmpz_mod_poly_oz_ntt_set_ui(rop, 1, n);
   while(e>0) {
     if (e&1)
-      fmpz_mod_poly_oz_ntt_mul(rop, rop, tmp, n);
+      fmpz_mod_poly_oz_ntt_mul_ctx(rop, rop, tmp, n, ctx);
     e = e>>1;
-    fmpz_mod_poly_oz_ntt_mul(tmp, tmp, tmp, n);
+    fmpz_mod_poly_oz_ntt_mul_ctx(tmp, tmp, tmp, n, ctx);
   }
+  fmpz_mod_oz_limb_ctx_clear(ctx);
   fmpz_mod_poly_clear(tmp);
 }
 
-void fmpz_mod_poly_oz_ntt_enc_fmpz_poly(fmpz_mod_poly_t rop, const fmpz_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp) {
-  const fmpz *q = fmpz_mod_poly_modulus(precomp->phi);
-  fmpz_mod_poly_realloc(rop, precomp->n);
-
-  fmpz_poly_t t; fmpz_poly_init2(t, precomp->n);
-  fmpz_poly_set(t, op);
-
-/* #pragma omp parallel for */
-  for(size_t i=0; i<precomp->n; i++) {
-    fmpz_mul(rop->coeffs+i, precomp->phi->coeffs+i, t->coeffs+i);
-    fmpz_mod(rop->coeffs+i, rop->coeffs+i, q);
+static void _fmpz_mod_poly_oz_ntt_enc(fmpz_mod_poly_t rop, const fmpz *op, const size_t len, const int reduce,
+                                      const fmpz_mod_poly_oz_ntt_precomp_t precomp, fmpz_mod_poly_oz_ntt_ws_t ws) {
+  const size_t n = precomp->n;
+  const fmpz *q = fmpz_mod_poly_modulus(precomp->phi_br);
+  assert(len <= n);
+  fmpz_mod_poly_fit_length(rop, n);
+
+  if (reduce) {
+    const int num_threads = _fmpz_mod_poly_oz_ntt_threads(precomp, ws);
+#pragma omp parallel for num_threads(num_threads) if(num_threads > 1) schedule(static)
+    for(size_t i=0; i<len; i++)
+      fmpz_mod(rop->coeffs+i, op+i, q);
+  } else if (rop->coeffs != op) {
+    _fmpz_vec_set(rop->coeffs, op, len);
   }
-  rop->length = precomp->n;
-  _fmpz_mod_poly_oz_ntt(rop, rop, precomp->w, precomp->n);
-  fmpz_poly_clear(t);
+  _fmpz_vec_zero(rop->coeffs+len, n-len);
+  rop->length = n;
+  _fmpz_mod_poly_oz_ntt_precomp_ct(rop->coeffs, precomp, ws);
 }
 
-void fmpz_mod_poly_oz_ntt_enc(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp) {
-  const fmpz *q = fmpz_mod_poly_modulus(op);
-  fmpz_mod_poly_realloc(rop, precomp->n);
+void fmpz_mod_poly_oz_ntt_enc_fmpz_poly_ws(fmpz_mod_poly_t rop, const fmpz_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp,
+                                           fmpz_mod_poly_oz_ntt_ws_t ws) {
+  _fmpz_mod_poly_oz_ntt_enc(rop, op->coeffs, fmpz_poly_length(op), 1, precomp, ws);
+}
 
-/* #pragma omp parallel for */
-  for(size_t i=0; i<precomp->n; i++) {
-    fmpz_mul(rop->coeffs+i, precomp->phi->coeffs+i, op->coeffs+i);
-    fmpz_mod(rop->coeffs+i, rop->coeffs+i, q);
-  }
-  rop->length = precomp->n;
-  _fmpz_mod_poly_oz_ntt(rop, rop, precomp->w, precomp->n);
+void fmpz_mod_poly_oz_ntt_enc_ws(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp,
+                                 fmpz_mod_poly_oz_ntt_ws_t ws) {
+  fmpz_mod_poly_fit_length(rop, precomp->n); // rop and op might be aliased
+  _fmpz_mod_poly_oz_ntt_enc(rop, op->coeffs, fmpz_mod_poly_length(op), 0, precomp, ws);
 }
 
-void fmpz_mod_poly_oz_ntt_dec(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp) {
-  const fmpz *q = fmpz_mod_poly_modulus(op);
+void fmpz_mod_poly_oz_ntt_dec_ws(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp,
+                                 fmpz_mod_poly_oz_ntt_ws_t ws) {
+  const size_t n = precomp->n;
+  const size_t len = fmpz_mod_poly_length(op);
+  assert(len <= n);
 
-  _fmpz_mod_poly_oz_ntt(rop, op, precomp->w_inv, precomp->n);
+  fmpz_mod_poly_set(rop, op);
+  fmpz_mod_poly_fit_length(rop, n);
+  _fmpz_vec_zero(rop->coeffs+len, n-len);
+  rop->length = n;
 
-/* #pragma omp parallel for */
-  for(size_t i=0; i<precomp->n; i++) {
-    fmpz_mul(rop->coeffs+i, precomp->phi_inv->coeffs+i, rop->coeffs+i);
-    fmpz_mod(rop->coeffs+i, rop->coeffs+i, q);
-  }
+  _fmpz_mod_poly_oz_ntt_precomp_gs(rop->coeffs, precomp, ws);
+  _fmpz_mod_poly_normalise(rop);
 }
 
+void fmpz_mod_poly_oz_ntt_enc_fmpz_poly(fmpz_mod_poly_t rop, const fmpz_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp) {
+  fmpz_mod_poly_oz_ntt_ws_t ws;
+  fmpz_mod_poly_oz_ntt_ws_init(ws, precomp);
+  fmpz_mod_poly_oz_ntt_enc_fmpz_poly_ws(rop, op, precomp, ws);
+  fmpz_mod_poly_oz_ntt_ws_clear(ws);
+}
+
+void fmpz_mod_poly_oz_ntt_enc(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp) {
+  fmpz_mod_poly_oz_ntt_ws_t ws;
+  fmpz_mod_poly_oz_ntt_ws_init(ws, precomp);
+  fmpz_mod_poly_oz_ntt_enc_ws(rop, op, precomp, ws);
+  fmpz_mod_poly_oz_ntt_ws_clear(ws);
+}
+
+void fmpz_mod_poly_oz_ntt_dec(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp) {
+  fmpz_mod_poly_oz_ntt_ws_t ws;
+  fmpz_mod_poly_oz_ntt_ws_init(ws, precomp);
+  fmpz_mod_poly_oz_ntt_dec_ws(rop, op, precomp, ws);
+  fmpz_mod_poly_oz_ntt_ws_clear(ws);
+}
 
 void _fmpz_mod_poly_oz_mul_nttnwc(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const fmpz_mod_poly_t g, const fmpz_mod_poly_oz_ntt_precomp_t precomp) {
   const size_t n = precomp->n;
@@ -289,16 +676,19 @@ void _fmpz_mod_poly_oz_mul_nttnwc(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, co
 
   fmpz_mod_poly_t F;  fmpz_mod_poly_init2(F, q, n);
   fmpz_mod_poly_t G;  fmpz_mod_poly_init2(G, q, n);
+  fmpz_mod_poly_oz_ntt_ws_t ws;
+  fmpz_mod_poly_oz_ntt_ws_init(ws, precomp);
 
-  fmpz_mod_poly_oz_ntt_enc(F, f, precomp);
-  fmpz_mod_poly_oz_ntt_enc(G, g, precomp);
+  fmpz_mod_poly_oz_ntt_enc_ws(F, f, precomp, ws);
+  fmpz_mod_poly_oz_ntt_enc_ws(G, g, precomp, ws);
 
-  fmpz_mod_poly_oz_ntt_mul(h, F, G, n);
+  fmpz_mod_poly_oz_ntt_mul_ws(h, F, G, precomp, ws);
 
   fmpz_mod_poly_clear(F);
   fmpz_mod_poly_clear(G);
 
-  fmpz_mod_poly_oz_ntt_dec(h, h, precomp);
+  fmpz_mod_poly_oz_ntt_dec_ws(h, h, precomp, ws);
+  fmpz_mod_poly_oz_ntt_ws_clear(ws);
 }
 
 void fmpz_mod_poly_oz_mul_nttnwc(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const fmpz_mod_poly_t g, const size_t n) {
@@ -9,6 +9,19 @@
    \mbox{NTT}_{ω_n}^{-1}(\mbox{NTT}_{ω_n}(\overline{a}) \odot \mbox{NTT}_{ω_n}(\overline{b}))@f$
    where @f$\mbox{NTT}_{ω_n}(·)@f$ is the number-theoretic transform and
    @f$\mbox{NTT}_{ω_n}^{-1}(·)@f$ is its inverse.
+
+   We never compute @f$\overline{a}@f$ explicitly. Encodings produced by `fmpz_mod_poly_oz_ntt_enc()`
+   are computed in place by a negacyclic Cooley-Tukey transform whose twiddle factors are the powers
+   of $φ$ in bit-reversed order, which absorbs the twist into the butterflies. The output is
+   @f$\mbox{NTT}_{ω_n}(\overline{a})@f$ in bit-reversed order, i.e. @f$a(φ^{2\mathrm{brv}(j)+1})@f$
+   at index $j$. The decoding uses a Gentleman-Sande transform with inverse powers of $φ$ which
+   consumes this order directly and applies $1/n$ in its last stage. Since all operations in the
+   NTT domain are coefficient-wise, the order does not matter to callers.
+
+   Products modulo $q$ never call `fmpz_mod`. The butterflies multiply by twiddle factors kept in
+   Montgomery form $φ^iR \bmod q$, so a single Montgomery reduction yields $φ^i·y \bmod q$ in
+   standard form, and pointwise products use Barrett reduction, see limb.h. If $q$ has special
+   form both use folding instead.
  */
 
 #ifndef NTT_H
@@ -18,6 +31,38 @@
 #include <stdio.h>
 #include <mpfr.h>
 #include <flint/fmpz_mod_poly.h>
+#include "limb.h"
+
+/**
+   @brief Transforms and pointwise operations of length below this are not parallelised.
+*/
+
+#ifndef OZ_NTT_PARALLEL_THRESHOLD
+#define OZ_NTT_PARALLEL_THRESHOLD 4096
+#endif
+
+/**
+   @brief Scratch space for the in-place number-theoretic transform.
+
+   A workspace is used by one thread at a time. Its temporary and limb scratch space are
+   pre-allocated so that transforms do not touch the heap. Transforms of length ≥
+   `OZ_NTT_PARALLEL_THRESHOLD` run on the workspace itself and its `team`, so that no scratch space
+   is shared between callers.
+*/
+
+struct fmpz_mod_poly_oz_ntt_ws_struct {
+  fmpz_t t;                   //!< temporary for butterflies and pointwise products
+  const struct fmpz_mod_oz_limb_ctx_struct *ctx; //!< modulus of the pre-computation this workspace belongs to
+  mp_limb_t *scratch;         //!< `OZ_LIMB_FMPZ_MULMOD_SCRATCH(L)` limbs
+  int nteam;                  //!< number of workspaces in `team`
+  struct fmpz_mod_poly_oz_ntt_ws_struct *team; //!< workspaces for threads $1,…,$`nteam` of parallel transforms
+};
+
+/**
+   @brief Scratch space for the in-place number-theoretic transform.
+*/
+
+typedef struct fmpz_mod_poly_oz_ntt_ws_struct fmpz_mod_poly_oz_ntt_ws_t[1];
 
 /**
    @brief Pre-computed data for number-theoretic transform
@@ -25,10 +70,15 @@
 
 struct fmpz_mod_poly_oz_ntt_precomp_struct {
   size_t n;                   //!< dimension, must be a  power of two
-  fmpz_mod_poly_t w;          //!< a vector holding $ω_n^i$ at index $i$ where $ω_n$ as an $n$-th root of unity.
-  fmpz_mod_poly_t w_inv;      //!< a vector holding $ω_n^{-i}$ at index $i$ where $ω_n$ as an $n$-th root of unity.
-  fmpz_mod_poly_t phi;        //!< a vector holding $φ^i$ at index $i$ where @f$φ = \sqrt{ω_n} \bmod q@f$.
-  fmpz_mod_poly_t phi_inv;    //!< a vector holding $φ^{-i}$ at index $i$ where @f$φ = \sqrt{ω_n} \bmod q@f$.
+  fmpz_mod_poly_t phi_br;     //!< a vector holding $φ^{\mathrm{brv}(i)}$ at index $i$ where @f$φ = \sqrt{ω_n} \bmod q@f$ and brv reverses $\log_2 n$ bits.
+  fmpz_mod_poly_t phi_inv_br; //!< a vector holding $φ^{-\mathrm{brv}(i)}$ at index $i$, with $1/n$ folded into index $1$.
+  fmpz_t n_inv;               //!< $1/n \bmod q$
+  fmpz_mod_oz_limb_ctx_t ctx; //!< $q$ as limbs with Barrett and Montgomery constants
+  mp_limb_t *phi_br_mont;     //!< `phi_br` as $n·L$ limbs, in Montgomery form if `fmpz_mod_oz_limb_ctx_prefers_mont()`
+  mp_limb_t *phi_inv_br_mont; //!< `phi_inv_br` as $n·L$ limbs, in Montgomery form if `fmpz_mod_oz_limb_ctx_prefers_mont()`
+  mp_limb_t *n_inv_mont;      //!< `n_inv` as $L$ limbs, in Montgomery form if `fmpz_mod_oz_limb_ctx_prefers_mont()`
+  size_t *brv;                //!< bit-reversal permutation on $\{0,…,n-1\}$
+  int num_threads;            //!< number of OpenMP threads used by transforms of length ≥ `OZ_NTT_PARALLEL_THRESHOLD`
 };
 
 /**
@@ -37,18 +87,57 @@ struct fmpz_mod_poly_oz_ntt_precomp_struct {
 
 typedef struct fmpz_mod_poly_oz_ntt_precomp_struct fmpz_mod_poly_oz_ntt_precomp_t[1];
 
+/**
+   @brief Return the number of threads to use for parallel transforms and pointwise operations.
+
+   This is the value of the environment variable `OZ_NUM_THREADS` if it is set to a positive
+   integer, `omp_get_max_threads()` otherwise. It is read when limb contexts and pre-computations
+   are initialised, loops use their `num_threads` field.
+*/
+
+int fmpz_mod_poly_oz_ntt_num_threads(void);
+
 /**
    @brief Pre-compute NTT data for $\\ZZ_q[x]/\\ideal{x^n+1}$.
+
+   The number of threads used by transforms and pointwise operations with this pre-computation is
+   initialised from `fmpz_mod_poly_oz_ntt_num_threads()` and may be lowered by setting
+   `op->num_threads`.
 */
 
 void fmpz_mod_poly_oz_ntt_precomp_init(fmpz_mod_poly_oz_ntt_precomp_t op, const size_t n, const fmpz_t q);
 
+/**
+   @brief Pre-compute NTT data for $\\ZZ_q[x]/\\ideal{x^n+1}$ given a primitive $2n$-th root of unity $φ$.
+
+   This does not require $q$ to be prime, it is used when $q$ is a product of primes and $φ$ was
+   assembled from roots modulo each prime.
+*/
+
+void _fmpz_mod_poly_oz_ntt_precomp_init_phi(fmpz_mod_poly_oz_ntt_precomp_t op, const size_t n, const fmpz_t q, const fmpz_t phi);
+
 /**
    @brief Clear pre-computed data.
 */
 
 void fmpz_mod_poly_oz_ntt_precomp_clear(fmpz_mod_poly_oz_ntt_precomp_t op);
 
+/**
+   @brief Initialise workspace for transforms using `precomp`.
+
+   If $n ≥$ `OZ_NTT_PARALLEL_THRESHOLD` and this is not called inside a parallel region, this
+   allocates a team of `precomp->num_threads - 1` further workspaces. Transforms with `ws` use at
+   most as many threads as `precomp->num_threads` had at the time of initialisation.
+*/
+
+void fmpz_mod_poly_oz_ntt_ws_init(fmpz_mod_poly_oz_ntt_ws_t ws, const fmpz_mod_poly_oz_ntt_precomp_t precomp);
+
+/**
+   @brief Clear workspace.
+*/
+
+void fmpz_mod_poly_oz_ntt_ws_clear(fmpz_mod_poly_oz_ntt_ws_t ws);
+
 /**
    @brief Compute @f$\mbox{rop} = \NTT{\mbox{op}}@f$.
 */
@@ -63,22 +152,52 @@ void fmpz_mod_poly_oz_intt(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const
 
 /**
    @brief Compute @f$\mbox{rop} = \NTT{\mbox{op}}@f$ using `precomp`.
+
+   This allocates a temporary workspace, use `fmpz_mod_poly_oz_ntt_enc_ws()` in loops.
 */
 
 void fmpz_mod_poly_oz_ntt_enc(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp);
 
+/**
+   @brief Compute @f$\mbox{rop} = \NTT{\mbox{op}}@f$ using `precomp` and workspace `ws`.
+
+   `op` must have at most $n$ coefficients. Once `rop` was used as an encoding before, this
+   function does not allocate memory.
+*/
+
+void fmpz_mod_poly_oz_ntt_enc_ws(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp,
+                                 fmpz_mod_poly_oz_ntt_ws_t ws);
+
 /**
    @brief Compute @f$\mbox{rop} = \NTT{\mbox{op}}@f$ using `precomp` for @f$\mbox{op} \in \ZZ[x]/\ideal{x^n+1}@f$.
 */
 
 void fmpz_mod_poly_oz_ntt_enc_fmpz_poly(fmpz_mod_poly_t rop, const fmpz_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp);
 
+/**
+   @brief Compute @f$\mbox{rop} = \NTT{\mbox{op}}@f$ using `precomp` and workspace `ws` for @f$\mbox{op} \in \ZZ[x]/\ideal{x^n+1}@f$.
+
+   `op` must be reduced modulo $x^n+1$, i.e. have at most $n$ coefficients.
+*/
+
+void fmpz_mod_poly_oz_ntt_enc_fmpz_poly_ws(fmpz_mod_poly_t rop, const fmpz_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp,
+                                           fmpz_mod_poly_oz_ntt_ws_t ws);
+
 /**
    @brief Compute @f$\mbox{rop} = \INTT{\mbox{op}}@f$ using `precomp`.
 */
 
 void fmpz_mod_poly_oz_ntt_dec(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp);
 
+/**
+   @brief Compute @f$\mbox{rop} = \INTT{\mbox{op}}@f$ using `precomp` and workspace `ws`.
+
+   `op` must have at most $n$ coefficients.
+*/
+
+void fmpz_mod_poly_oz_ntt_dec_ws(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_ntt_precomp_t precomp,
+                                 fmpz_mod_poly_oz_ntt_ws_t ws);
+
 /**
    @brief Compute @f$\mbox{rop} = \NTT{c}@f$ using `precomp`.
 */
@@ -97,12 +216,44 @@ void fmpz_mod_poly_oz_ntt_set_ui(fmpz_mod_poly_t rop, const unsigned long c, con
 
 void fmpz_mod_poly_oz_ntt_mul(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const fmpz_mod_poly_t g, const size_t n);
 
+/**
+   @brief Compute $h = \NTT{f' · g'}$ as `fmpz_mod_poly_oz_ntt_mul()` using the pre-computed
+   reduction constants in `ctx`.
+
+   `fmpz_mod_poly_oz_ntt_mul()` derives these constants from the modulus of `f` on every call, use
+   this function or `fmpz_mod_poly_oz_ntt_mul_ws()` in loops.
+*/
+
+void fmpz_mod_poly_oz_ntt_mul_ctx(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const fmpz_mod_poly_t g, const size_t n,
+                                  const fmpz_mod_oz_limb_ctx_t ctx);
+
+/**
+   @brief Compute $h = \NTT{f' · g'}$ as `fmpz_mod_poly_oz_ntt_mul()` using `precomp->ctx` and the
+   scratch space in `ws`.
+
+   This function does not allocate memory once `h` holds $n$ coefficients.
+*/
+
+void fmpz_mod_poly_oz_ntt_mul_ws(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const fmpz_mod_poly_t g,
+                                 const fmpz_mod_poly_oz_ntt_precomp_t precomp, fmpz_mod_poly_oz_ntt_ws_t ws);
+
 /**
    @brief Compute $h = \\NTT{f'^{-1}}$  where $f' \\in \\ZZ_q[x]/\\ideal{x^n+1}$ from $f = \\NTT{f'}$.
 */
 
 void fmpz_mod_poly_oz_ntt_inv(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const size_t n);
 
+/**
+   @brief Compute $h = \\NTT{f'^{-1}}$ as `fmpz_mod_poly_oz_ntt_inv()` using the pre-computed
+   reduction constants in `ctx`.
+
+   All $n$ evaluations are inverted with a single `fmpz_invmod()` and about $3n$ multiplications
+   (Montgomery's trick), split into one block per thread.
+*/
+
+void fmpz_mod_poly_oz_ntt_inv_ctx(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, const size_t n,
+                                  const fmpz_mod_oz_limb_ctx_t ctx);
+
 /**
    @brief Compute $h = \\NTT{f'^e}$  where $f' \\in \\ZZ_q[x]/\\ideal{x^n+1}$ from $f = \\NTT{f'}$.
 */
@@ -115,6 +266,54 @@ void fmpz_mod_poly_oz_ntt_pow_ui(fmpz_mod_poly_t h, const fmpz_mod_poly_t f, uns
 
 void _fmpz_mod_poly_oz_ntt(fmpz_mod_poly_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_t w, const size_t n);
 
+/**
+   @brief In-place negacyclic Cooley-Tukey transform of $a$ with entries in $[0,q)$, output in bit-reversed order.
+
+   @param a        vector of length $n$
+   @param phi_br   $(φ^{\mathrm{brv}(0)},…,φ^{\mathrm{brv}(n-1)})$ as limbs as in `phi_br_mont` of `fmpz_mod_poly_oz_ntt_precomp_t`
+   @param n        power of two
+   @param q        modulus
+   @param ws       workspace
+*/
+
+void _fmpz_vec_oz_ntt_ct(fmpz *a, const mp_limb_t *phi_br, const size_t n, const fmpz_t q, fmpz_mod_poly_oz_ntt_ws_t ws);
+
+/**
+   @brief In-place negacyclic Gentleman-Sande transform of $a$ given in bit-reversed order, output in natural order.
+
+   The output is scaled by `n_inv` in the last stage, hence `phi_inv_br[1]` must have `n_inv`
+   folded in already as in `fmpz_mod_poly_oz_ntt_precomp_t`.
+
+   @param a          vector of length $n$
+   @param phi_inv_br $(φ^{-\mathrm{brv}(0)},…,φ^{-\mathrm{brv}(n-1)})$ with `n_inv` folded into index $1$, as limbs as in `phi_inv_br_mont`
+   @param n_inv      $1/n \bmod q$ as limbs as in `n_inv_mont`
+   @param n          power of two
+   @param q          modulus
+   @param ws         workspace
+*/
+
+void _fmpz_vec_oz_ntt_gs(fmpz *a, const mp_limb_t *phi_inv_br, const mp_limb_t *n_inv, const size_t n, const fmpz_t q, fmpz_mod_poly_oz_ntt_ws_t ws);
+
+/**
+   @brief Parallel variant of `_fmpz_vec_oz_ntt_ct()`.
+
+   @param ws           workspace, thread $0$ uses `ws` and thread $i > 0$ uses `ws->team[i-1]`
+   @param num_threads  number of OpenMP threads, at most `ws->nteam + 1`
+*/
+
+void _fmpz_vec_oz_ntt_ct_par(fmpz *a, const mp_limb_t *phi_br, const size_t n, const fmpz_t q,
+                             fmpz_mod_poly_oz_ntt_ws_t ws, const int num_threads);
+
+/**
+   @brief Parallel variant of `_fmpz_vec_oz_ntt_gs()`.
+
+   @param ws           workspace, thread $0$ uses `ws` and thread $i > 0$ uses `ws->team[i-1]`
+   @param num_threads  number of OpenMP threads, at most `ws->nteam + 1`
+*/
+
+void _fmpz_vec_oz_ntt_gs_par(fmpz *a, const mp_limb_t *phi_inv_br, const mp_limb_t *n_inv, const size_t n, const fmpz_t q,
+                             fmpz_mod_poly_oz_ntt_ws_t ws, const int num_threads);
+
 /**
    @brief Compute $h = f · g$ using the number-theoretic transform using `precomp`.
 */
@@ -184,6 +184,8 @@ int fmpz_poly_oz_coprime_det(const fmpz_poly_t b0, const fmpz_t det_b1, const lo
 
 #include <oz/mul.h>
 #include <oz/ntt.h>
+#include <oz/rns.h>
+#include <oz/limb.h>
 #include <oz/invert.h>
 #include <oz/sqrt.h>
 #include <oz/norm.h>
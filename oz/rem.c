@@ -69,10 +69,44 @@ void _fmpz_poly_oz_rem_small_fmpz(fmpz_poly_t rem, const fmpz_t f, const fmpz_po
   fmpz_clear(fc);
 }
 
-void _fmpz_poly_oz_rem_small_fmpz_split(fmpz_poly_t rem, const fmpz_t f, const fmpz_poly_t g,
-                                        const long n, const fmpq_poly_t g_inv, const mp_bitcnt_t b) {
+void fmpz_poly_oz_rem_split_init(fmpz_poly_oz_rem_split_t self, const fmpz_poly_t g, const long n,
+                                 const fmpq_poly_t g_inv, const mp_bitcnt_t b, const size_t k) {
+  assert(k > 0);
+  self->b = b;
+  self->k = k;
+  self->rem_bound = log2(n) * labs(fmpz_poly_max_bits(g)) + 128;
 
-  const size_t num_threads = omp_get_max_threads();
+  // powb[i] ~= 2^((i+1)b)
+  self->powb = (fmpz_poly_t*)malloc(k * sizeof(fmpz_poly_t));
+  fmpz_poly_t *powb = self->powb;
+
+  for(size_t j=0; j<k; j++) {
+    fmpz_poly_init(powb[j]);
+  }
+  fmpz_poly_set_coeff_ui(powb[0], 0, 2); // powb ~= 2^b
+  fmpz_pow_ui(powb[0]->coeffs, powb[0]->coeffs, b);
+  _fmpz_poly_oz_rem_small_fmpz(powb[0], powb[0]->coeffs, g, n, g_inv, self->rem_bound);
+
+  for(size_t j=1; j<k; j++) {
+    fmpz_poly_oz_mul(powb[j], powb[j-1], powb[0], n);
+    _fmpz_poly_oz_rem_small_iter(powb[j], powb[j], g, n, g_inv, 0, 0);
+  }
+}
+
+void fmpz_poly_oz_rem_split_clear(fmpz_poly_oz_rem_split_t self) {
+  for(size_t j=0; j<self->k; j++)
+    fmpz_poly_clear(self->powb[j]);
+  free(self->powb);
+}
+
+void _fmpz_poly_oz_rem_small_fmpz_split_precomp(fmpz_poly_t rem, const fmpz_t f, const fmpz_poly_t g,
+                                                const long n, const fmpq_poly_t g_inv,
+                                                const fmpz_poly_oz_rem_split_t split) {
+
+  const size_t num_threads = split->k;
+  const mp_bitcnt_t b = split->b;
+  const mp_bitcnt_t rem_bound = split->rem_bound;
+  fmpz_poly_t *powb = split->powb;
 
   fmpz_t F; fmpz_init_set(F, f);
   fmpz_t H; fmpz_init(H);
@@ -91,22 +125,6 @@ void _fmpz_poly_oz_rem_small_fmpz_split(fmpz_poly_t rem, const fmpz_t f, const f
   }
 
   const mp_bitcnt_t B = num_threads*b;
-  const mp_bitcnt_t rem_bound = log2(n) * labs(fmpz_poly_max_bits(g)) + 128;
-
-  // powb[i] ~= 2^((i+1)b)
-  fmpz_poly_t powb[num_threads];
-
-  for(size_t j=0; j<num_threads; j++) {
-    fmpz_poly_init(powb[j]);
-  }
-  fmpz_poly_set_coeff_ui(powb[0], 0, 2); // powb ~= 2^b
-  fmpz_pow_ui(powb[0]->coeffs, powb[0]->coeffs, b);
-  _fmpz_poly_oz_rem_small_fmpz(powb[0], powb[0]->coeffs, g, n, g_inv, rem_bound);
-
-  for(size_t j=1; j<num_threads; j++) {
-    fmpz_poly_oz_mul(powb[j], powb[j-1], powb[0], n);
-    _fmpz_poly_oz_rem_small_iter(powb[j], powb[j], g, n, g_inv, 0, 0);
-  }
 
   const size_t nparts = (fmpz_sizeinbase(f, 2)/B) + ((fmpz_sizeinbase(f, 2)%B) ? 1 : 0);
 
@@ -153,11 +171,18 @@ void _fmpz_poly_oz_rem_small_fmpz_split(fmpz_poly_t rem, const fmpz_t f, const f
     fmpz_clear(H_[j]);
     fmpz_poly_clear(f_[j]);
     fmpz_poly_clear(t_[j]);
-    fmpz_poly_clear(powb[j]);
   }
 
 }
 
+void _fmpz_poly_oz_rem_small_fmpz_split(fmpz_poly_t rem, const fmpz_t f, const fmpz_poly_t g,
+                                        const long n, const fmpq_poly_t g_inv, const mp_bitcnt_t b) {
+  fmpz_poly_oz_rem_split_t split;
+  fmpz_poly_oz_rem_split_init(split, g, n, g_inv, b, omp_get_max_threads());
+  _fmpz_poly_oz_rem_small_fmpz_split_precomp(rem, f, g, n, g_inv, split);
+  fmpz_poly_oz_rem_split_clear(split);
+}
+
 void _fmpz_poly_oz_rem_small(fmpz_poly_t rem, const fmpz_poly_t f, const fmpz_poly_t g, const long n, const fmpq_poly_t g_inv) {
   fmpz_poly_t fc; fmpz_poly_init(fc); fmpz_poly_set(fc, f);
   fmpq_poly_t fq; fmpq_poly_init(fq);
@@ -194,10 +219,11 @@ void fmpz_poly_oz_rem_small(fmpz_poly_t rem, const fmpz_poly_t f, const fmpz_pol
 }
 
 
-void _fmpz_poly_oz_rem_small_iter(fmpz_poly_t rem, const fmpz_poly_t f, const fmpz_poly_t g,
-                                  const long n, const fmpq_poly_t ginv, const mp_bitcnt_t b, const oz_flag_t flags) {
+/* `split` may be NULL, in which case it is computed for chunks of size `prec` if needed */
 
-  mp_bitcnt_t prec = (b) ? b : labs(_fmpz_vec_max_bits(ginv->coeffs, fmpq_poly_length(ginv)))/2;
+static void _fmpz_poly_oz_rem_small_iter_(fmpz_poly_t rem, const fmpz_poly_t f, const fmpz_poly_t g,
+                                          const long n, const fmpq_poly_t ginv, const mp_bitcnt_t prec,
+                                          const fmpz_poly_oz_rem_split_t split, const oz_flag_t flags) {
   fmpz_poly_t t_i;  fmpz_poly_init(t_i);
   fmpz_poly_t t_o;  fmpz_poly_init(t_o);
   mpfr_t norm_i; mpfr_init2(norm_i, prec);
@@ -209,7 +235,10 @@ void _fmpz_poly_oz_rem_small_iter(fmpz_poly_t rem, const fmpz_poly_t f, const fm
 
   if (fmpz_poly_degree(f) == 0) {
     uint64_t t = oz_walltime(0);
-    _fmpz_poly_oz_rem_small_fmpz_split(t_o, f->coeffs, g, n, g_inv, prec);
+    if (split)
+      _fmpz_poly_oz_rem_small_fmpz_split_precomp(t_o, f->coeffs, g, n, g_inv, split);
+    else
+      _fmpz_poly_oz_rem_small_fmpz_split(t_o, f->coeffs, g, n, g_inv, prec);
     t = oz_walltime(t);
 
     if (flags & OZ_VERBOSE) {
@@ -249,3 +278,15 @@ void _fmpz_poly_oz_rem_small_iter(fmpz_poly_t rem, const fmpz_poly_t f, const fm
   fmpz_poly_clear(t_i);
   fmpz_poly_clear(t_o);
 }
+
+void _fmpz_poly_oz_rem_small_iter(fmpz_poly_t rem, const fmpz_poly_t f, const fmpz_poly_t g,
+                                  const long n, const fmpq_poly_t ginv, const mp_bitcnt_t b, const oz_flag_t flags) {
+  const mp_bitcnt_t prec = (b) ? b : labs(_fmpz_vec_max_bits(ginv->coeffs, fmpq_poly_length(ginv)))/2;
+  _fmpz_poly_oz_rem_small_iter_(rem, f, g, n, ginv, prec, NULL, flags);
+}
+
+void _fmpz_poly_oz_rem_small_iter_split(fmpz_poly_t rem, const fmpz_poly_t f, const fmpz_poly_t g,
+                                        const long n, const fmpq_poly_t ginv, const fmpz_poly_oz_rem_split_t split,
+                                        const oz_flag_t flags) {
+  _fmpz_poly_oz_rem_small_iter_(rem, f, g, n, ginv, split->b, split, flags);
+}
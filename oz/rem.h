@@ -10,6 +10,19 @@
 #include <flint/fmpq_poly.h>
 #include <oz/flags.h>
 
+struct fmpz_poly_oz_rem_split_struct {
+  mp_bitcnt_t b;           //!< chunk size in bits
+  size_t k;                //!< number of chunks processed per round
+  mp_bitcnt_t rem_bound;   //!< log_2 of bound on remainders
+  fmpz_poly_t *powb;       //!< small representatives of $2^{(j+1)b} \bmod \ideal{g}$
+};
+
+/**
+   @brief Pre-computed powers $2^{(j+1)b} \bmod \ideal{g}$ for $0 ≤ j < k$ used to split integers into chunks.
+*/
+
+typedef struct fmpz_poly_oz_rem_split_struct fmpz_poly_oz_rem_split_t[1];
+
 /**
    @brief Return a small representative of $f \\mod \\ideal{g}$.
 
@@ -50,6 +63,44 @@ void _fmpz_poly_oz_rem_small_fmpz(fmpz_poly_t rem, const fmpz_t f, const fmpz_po
 void _fmpz_poly_oz_rem_small_fmpz_split(fmpz_poly_t rem, const fmpz_t f, const fmpz_poly_t g,
                                         const long n, const fmpq_poly_t g_inv, const mp_bitcnt_t b);
 
+/**
+   @brief Pre-compute powers of $2^b$ modulo $\ideal{g}$ for splitting integers.
+
+   The result only depends on $g$, so it can be computed once and shared (read-only) between
+   threads reducing many integers modulo the same $\ideal{g}$.
+
+   @param self          return value
+   @param g             an element $g$ in $\R$
+   @param n             degree of cyclotomic polynomial, must be power of two
+   @param g_inv         pre-computed approximate inverse of $g$ in $\R$.
+   @param b             process integers in chunks of size $b$ bits.
+   @param k             process $k$ chunks per round, typically the number of threads
+ */
+
+void fmpz_poly_oz_rem_split_init(fmpz_poly_oz_rem_split_t self, const fmpz_poly_t g, const long n,
+                                 const fmpq_poly_t g_inv, const mp_bitcnt_t b, const size_t k);
+
+/**
+   @brief Clear pre-computed powers of $2^b$ modulo $\ideal{g}$.
+ */
+
+void fmpz_poly_oz_rem_split_clear(fmpz_poly_oz_rem_split_t self);
+
+/**
+   @brief Return a small representative of $f \mod \ideal{g}$ with $f \in \Z$ using pre-computed powers.
+
+   @param rem           return value, a small representative of $f \bmod \ideal{g}$.
+   @param f             an element $f$ in $\Z$
+   @param g             an element $g$ in $\R$
+   @param n             degree of cyclotomic polynomial, must be power of two
+   @param g_inv         pre-computed approximate inverse of $g$ in $\R$.
+   @param split         output of `fmpz_poly_oz_rem_split_init()` for $g$
+ */
+
+void _fmpz_poly_oz_rem_small_fmpz_split_precomp(fmpz_poly_t rem, const fmpz_t f, const fmpz_poly_t g,
+                                                const long n, const fmpq_poly_t g_inv,
+                                                const fmpz_poly_oz_rem_split_t split);
+
 /**
    @brief Return a small representative of $f \\mod \\ideal{g}$.
 
@@ -77,4 +128,23 @@ void _fmpz_poly_oz_rem_small_iter(fmpz_poly_t rem,
                                   const fmpz_poly_t f, const fmpz_poly_t g, const long n, const fmpq_poly_t ginv,
                                   const mp_bitcnt_t b, const oz_flag_t flags);
 
+/**
+   @brief Return a small representative of $f \mod \ideal{g}$ using pre-computed powers.
+
+   As `_fmpz_poly_oz_rem_small_iter()` with `b = split->b` but without recomputing `split` for
+   constant $f$.
+
+   @param rem           return value, a small representative of $f \bmod \ideal{g}$.
+   @param f             an element $f$ in $\R$
+   @param g             an element $g$ in $\R$
+   @param n             degree of cyclotomic polynomial, must be power of two
+   @param ginv          pre-computed approximate inverse of $g$ in $\R$.
+   @param split         output of `fmpz_poly_oz_rem_split_init()` for $g$
+   @param flags         flags controlling verbosity et al.
+ */
+
+void _fmpz_poly_oz_rem_small_iter_split(fmpz_poly_t rem, const fmpz_poly_t f, const fmpz_poly_t g,
+                                        const long n, const fmpq_poly_t ginv, const fmpz_poly_oz_rem_split_t split,
+                                        const oz_flag_t flags);
+
 #endif /* _REM_H */
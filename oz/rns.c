@@ -0,0 +1,318 @@
+#include <assert.h>
+#include "rns.h"
+#include "util.h"
+
+/**
+   Return the largest prime $p ≤ c$ with $p ≡ 1 \bmod 2n$ where $c ≡ 1 \bmod 2n$.
+*/
+
+static mp_limb_t _n_oz_rns_prime(mp_limb_t c, const size_t n) {
+  while(c > 2*n) {
+    if (n_is_prime(c))
+      return c;
+    c -= 2*n;
+  }
+  oz_die("ran out of primes p ≡ 1 mod 2n");
+  return 0;
+}
+
+static mp_limb_t _n_oz_rns_prime_start(const size_t n) {
+  const mp_limb_t b = (UWORD(1)<<OZ_RNS_PRIME_BITS) - 1;
+  return (b/(2*n))*(2*n) + 1;
+}
+
+void fmpz_mod_poly_oz_rns_modulus(fmpz_t q, const size_t n, const size_t bits) {
+  fmpz_set_ui(q, 1);
+  mp_limb_t p = _n_oz_rns_prime_start(n);
+  while(fmpz_sizeinbase(q, 2) < bits) {
+    p = _n_oz_rns_prime(p, n);
+    fmpz_mul_ui(q, q, p);
+    p -= 2*n;
+  }
+}
+
+/**
+   Find a primitive $2n$-th root of unity modulo $p$.
+*/
+
+static mp_limb_t _n_oz_rns_root(const mp_limb_t p, const mp_limb_t p_inv, const size_t n) {
+  for(mp_limb_t a=2; a<p; a++) {
+    if (n_powmod2_preinv(a, (p-1)/2, p, p_inv) == p-1)
+      return n_powmod2_preinv(a, (p-1)/(2*n), p, p_inv);
+  }
+  oz_die("p does not have a 2n-th root of unity");
+  return 0;
+}
+
+/**
+   Set $op_j = w^{\mathrm{brv}(j)}$ for $0 ≤ j < m$ where brv reverses $\log_2 m$ bits.
+*/
+
+static void _nmod_vec_oz_set_powers_br(mp_limb_t *op, mp_limb_t *op_shoup, const size_t m, const mp_limb_t w,
+                                       const mp_limb_t p, const mp_limb_t p_inv) {
+  mp_limb_t acc = 1;
+  for(size_t j=0, r=0; j<m; j++) {
+    op[r] = acc;
+    op_shoup[r] = n_oz_mulmod_shoup_precomp(acc, p);
+    acc = n_mulmod2_preinv(acc, w, p, p_inv);
+    /* r = brv(j+1) */
+    size_t bit = m>>1;
+    for(; r & bit; bit >>= 1)
+      r ^= bit;
+    r ^= bit;
+  }
+}
+
+void fmpz_mod_poly_oz_rns_precomp_init(fmpz_mod_poly_oz_rns_precomp_t op, const size_t n, const fmpz_t q) {
+  op->n = n;
+  fmpz_init_set(op->q, q);
+
+  fmpz_t t;  fmpz_init_set_ui(t, 1);
+  size_t k = 0;
+  mp_limb_t p = _n_oz_rns_prime_start(n);
+  while(fmpz_cmp(t, q) < 0) {
+    p = _n_oz_rns_prime(p, n);
+    fmpz_mul_ui(t, t, p);
+    p -= 2*n;
+    k++;
+  }
+  if (!fmpz_equal(t, q)) {
+    fmpz_clear(t);
+    oz_die("q is not a product of word-sized primes p ≡ 1 mod 2n");
+  }
+  op->k = k;
+
+  op->p     = (mp_limb_t*)calloc(k, sizeof(mp_limb_t));
+  op->p_inv = (mp_limb_t*)calloc(k, sizeof(mp_limb_t));
+  op->m     = _fmpz_vec_init(k);
+  op->m_inv = (mp_limb_t*)calloc(k, sizeof(mp_limb_t));
+
+  op->phi_br           = (mp_limb_t*)calloc(k*n, sizeof(mp_limb_t));
+  op->phi_br_shoup     = (mp_limb_t*)calloc(k*n, sizeof(mp_limb_t));
+  op->phi_inv_br       = (mp_limb_t*)calloc(k*n, sizeof(mp_limb_t));
+  op->phi_inv_br_shoup = (mp_limb_t*)calloc(k*n, sizeof(mp_limb_t));
+  op->n_inv            = (mp_limb_t*)calloc(k, sizeof(mp_limb_t));
+  op->n_inv_shoup      = (mp_limb_t*)calloc(k, sizeof(mp_limb_t));
+
+  p = _n_oz_rns_prime_start(n);
+  for(size_t i=0; i<k; i++) {
+    p = _n_oz_rns_prime(p, n);
+    op->p[i] = p;
+    op->p_inv[i] = n_preinvert_limb(p);
+    p -= 2*n;
+  }
+
+  fmpz_init(op->phi_q);
+
+#pragma omp parallel for
+  for(size_t i=0; i<k; i++) {
+    const mp_limb_t p_i = op->p[i];
+    const mp_limb_t p_inv = op->p_inv[i];
+
+    fmpz_divexact_ui(op->m + i, q, p_i);
+    op->m_inv[i] = n_invmod(fmpz_fdiv_ui(op->m + i, p_i), p_i);
+
+    const mp_limb_t psi     = _n_oz_rns_root(p_i, p_inv, n);
+    const mp_limb_t psi_inv = n_invmod(psi, p_i);
+
+    _nmod_vec_oz_set_powers_br(op->phi_br     + i*n, op->phi_br_shoup     + i*n, n, psi,     p_i, p_inv);
+    _nmod_vec_oz_set_powers_br(op->phi_inv_br + i*n, op->phi_inv_br_shoup + i*n, n, psi_inv, p_i, p_inv);
+
+    /** @note We fold 1/n into the last Gentleman-Sande stage, which is the only user of index 1 **/
+    op->n_inv[i]       = n_invmod(n % p_i, p_i);
+    op->n_inv_shoup[i] = n_oz_mulmod_shoup_precomp(op->n_inv[i], p_i);
+    if (n > 1) {
+      mp_limb_t *s = op->phi_inv_br + i*n + 1;
+      *s = n_mulmod2_preinv(*s, op->n_inv[i], p_i, p_inv);
+      op->phi_inv_br_shoup[i*n + 1] = n_oz_mulmod_shoup_precomp(*s, p_i);
+    }
+  }
+
+  /* φ = CRT(ψ_0,…,ψ_{k-1}), ψ_i = phi_br[i·n+brv(1)] = phi_br[i·n+n/2] */
+  for(size_t i=0; i<k; i++) {
+    const mp_limb_t psi = (n > 1) ? op->phi_br[i*n+n/2] : 1;
+    fmpz_addmul_ui(op->phi_q, op->m + i, n_mulmod2_preinv(psi, op->m_inv[i], op->p[i], op->p_inv[i]));
+  }
+  fmpz_mod(op->phi_q, op->phi_q, q);
+  fmpz_clear(t);
+}
+
+void fmpz_mod_poly_oz_rns_precomp_clear(fmpz_mod_poly_oz_rns_precomp_t op) {
+  free(op->phi_br);
+  free(op->phi_br_shoup);
+  free(op->phi_inv_br);
+  free(op->phi_inv_br_shoup);
+  free(op->n_inv);
+  free(op->n_inv_shoup);
+  free(op->p);
+  free(op->p_inv);
+  free(op->m_inv);
+  _fmpz_vec_clear(op->m, op->k);
+  fmpz_clear(op->phi_q);
+  fmpz_clear(op->q);
+}
+
+void fmpz_mod_poly_oz_ntt_precomp_init_rns(fmpz_mod_poly_oz_ntt_precomp_t op, const fmpz_mod_poly_oz_rns_precomp_t rns) {
+  _fmpz_mod_poly_oz_ntt_precomp_init_phi(op, rns->n, rns->q, rns->phi_q);
+}
+
+void fmpz_mod_poly_oz_rns_init(fmpz_mod_poly_oz_rns_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  op->n = precomp->n;
+  op->k = precomp->k;
+  op->coeffs = (mp_limb_t*)calloc(op->k*op->n, sizeof(mp_limb_t));
+}
+
+void fmpz_mod_poly_oz_rns_clear(fmpz_mod_poly_oz_rns_t op) {
+  free(op->coeffs);
+}
+
+void fmpz_mod_poly_oz_rns_set(fmpz_mod_poly_oz_rns_t rop, const fmpz_mod_poly_oz_rns_t op) {
+  assert(rop->n == op->n && rop->k == op->k);
+  if (rop != op)
+    flint_mpn_copyi(rop->coeffs, op->coeffs, op->k*op->n);
+}
+
+void _nmod_vec_oz_ntt_ct(mp_limb_t *a, const mp_limb_t *phi_br, const mp_limb_t *phi_br_shoup, const size_t n, const mp_limb_t p) {
+  for(size_t m=1, h=n/2; m<n; m<<=1, h>>=1) {
+    for(size_t i=0; i<m; i++) {
+      mp_limb_t *x = a + 2*i*h;
+      const mp_limb_t s = phi_br[m+i], s_ = phi_br_shoup[m+i];
+      for(size_t j=0; j<h; j++) {
+        const mp_limb_t u = x[j];
+        const mp_limb_t v = n_oz_mulmod_shoup(x[j+h], s, s_, p);
+        x[j]   = n_addmod(u, v, p);
+        x[j+h] = n_submod(u, v, p);
+      }
+    }
+  }
+}
+
+void _nmod_vec_oz_ntt_gs(mp_limb_t *a, const mp_limb_t *phi_inv_br, const mp_limb_t *phi_inv_br_shoup,
+                         const mp_limb_t n_inv, const mp_limb_t n_inv_shoup, const size_t n, const mp_limb_t p) {
+  for(size_t m=n/2, h=1; m>0; m>>=1, h<<=1) {
+    for(size_t i=0; i<m; i++) {
+      mp_limb_t *x = a + 2*i*h;
+      const mp_limb_t s = phi_inv_br[m+i], s_ = phi_inv_br_shoup[m+i];
+      for(size_t j=0; j<h; j++) {
+        const mp_limb_t u = x[j];
+        const mp_limb_t v = x[j+h];
+        x[j]   = n_addmod(u, v, p);
+        if (m == 1)
+          x[j] = n_oz_mulmod_shoup(x[j], n_inv, n_inv_shoup, p);
+        x[j+h] = n_oz_mulmod_shoup(n_submod(u, v, p), s, s_, p);
+      }
+    }
+  }
+}
+
+static void _fmpz_mod_poly_oz_rns_enc(fmpz_mod_poly_oz_rns_t rop, const fmpz *op, const size_t len, const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  const size_t n = precomp->n;
+
+#pragma omp parallel for
+  for(size_t i=0; i<precomp->k; i++) {
+    const mp_limb_t p = precomp->p[i];
+    mp_limb_t *a = rop->coeffs + i*n;
+    for(size_t j=0; j<n; j++)
+      a[j] = (j < len) ? fmpz_fdiv_ui(op + j, p) : 0;
+    _nmod_vec_oz_ntt_ct(a, precomp->phi_br + i*n, precomp->phi_br_shoup + i*n, n, p);
+  }
+}
+
+void fmpz_mod_poly_oz_rns_enc_fmpz_poly(fmpz_mod_poly_oz_rns_t rop, const fmpz_poly_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  _fmpz_mod_poly_oz_rns_enc(rop, op->coeffs, fmpz_poly_length(op), precomp);
+}
+
+void fmpz_mod_poly_oz_rns_enc(fmpz_mod_poly_oz_rns_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  _fmpz_mod_poly_oz_rns_enc(rop, op->coeffs, fmpz_mod_poly_length(op), precomp);
+}
+
+/**
+   Compute $\sum_i ((r_i·m_i^{-1}) \bmod p_i)·m_i \bmod q$ for residues $r_i$ at stride $n$.
+*/
+
+static inline void _fmpz_oz_rns_crt(fmpz_t rop, const mp_limb_t *r, const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  const size_t n = precomp->n;
+  fmpz_zero(rop);
+  for(size_t i=0; i<precomp->k; i++) {
+    const mp_limb_t t = n_mulmod2_preinv(r[i*n], precomp->m_inv[i], precomp->p[i], precomp->p_inv[i]);
+    fmpz_addmul_ui(rop, precomp->m + i, t);
+  }
+  fmpz_mod(rop, rop, precomp->q);
+}
+
+void fmpz_mod_poly_oz_rns_dec(fmpz_mod_poly_t rop, const fmpz_mod_poly_oz_rns_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  const size_t n = precomp->n;
+  mp_limb_t *t = (mp_limb_t*)calloc(precomp->k*n, sizeof(mp_limb_t));
+
+#pragma omp parallel for
+  for(size_t i=0; i<precomp->k; i++) {
+    const mp_limb_t p = precomp->p[i];
+    mp_limb_t *a = t + i*n;
+    flint_mpn_copyi(a, op->coeffs + i*n, n);
+    _nmod_vec_oz_ntt_gs(a, precomp->phi_inv_br + i*n, precomp->phi_inv_br_shoup + i*n,
+                        precomp->n_inv[i], precomp->n_inv_shoup[i], n, p);
+  }
+
+  fmpz_mod_poly_realloc(rop, n);
+#pragma omp parallel for
+  for(size_t j=0; j<n; j++)
+    _fmpz_oz_rns_crt(rop->coeffs + j, t + j, precomp);
+  rop->length = n;
+  _fmpz_mod_poly_normalise(rop);
+  free(t);
+}
+
+void fmpz_mod_poly_oz_rns_set_fmpz_mod_poly(fmpz_mod_poly_oz_rns_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  const size_t n = precomp->n;
+  const size_t len = fmpz_mod_poly_length(op);
+
+#pragma omp parallel for
+  for(size_t i=0; i<precomp->k; i++) {
+    for(size_t j=0; j<n; j++)
+      rop->coeffs[i*n+j] = (j < len) ? fmpz_fdiv_ui(op->coeffs + j, precomp->p[i]) : 0;
+  }
+}
+
+void fmpz_mod_poly_oz_rns_get_fmpz_mod_poly(fmpz_mod_poly_t rop, const fmpz_mod_poly_oz_rns_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  const size_t n = precomp->n;
+  fmpz_mod_poly_realloc(rop, n);
+#pragma omp parallel for
+  for(size_t j=0; j<n; j++)
+    _fmpz_oz_rns_crt(rop->coeffs + j, op->coeffs + j, precomp);
+  rop->length = n;
+  _fmpz_mod_poly_normalise(rop);
+}
+
+void fmpz_mod_poly_oz_rns_mul(fmpz_mod_poly_oz_rns_t h, const fmpz_mod_poly_oz_rns_t f, const fmpz_mod_poly_oz_rns_t g,
+                              const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  const size_t n = precomp->n;
+#pragma omp parallel for
+  for(size_t i=0; i<precomp->k; i++) {
+    const mp_limb_t p = precomp->p[i];
+    const mp_limb_t p_inv = precomp->p_inv[i];
+    for(size_t j=i*n; j<(i+1)*n; j++)
+      h->coeffs[j] = n_mulmod2_preinv(f->coeffs[j], g->coeffs[j], p, p_inv);
+  }
+}
+
+void fmpz_mod_poly_oz_rns_add(fmpz_mod_poly_oz_rns_t h, const fmpz_mod_poly_oz_rns_t f, const fmpz_mod_poly_oz_rns_t g,
+                              const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  const size_t n = precomp->n;
+#pragma omp parallel for
+  for(size_t i=0; i<precomp->k; i++) {
+    const mp_limb_t p = precomp->p[i];
+    for(size_t j=i*n; j<(i+1)*n; j++)
+      h->coeffs[j] = n_addmod(f->coeffs[j], g->coeffs[j], p);
+  }
+}
+
+void fmpz_mod_poly_oz_rns_sub(fmpz_mod_poly_oz_rns_t h, const fmpz_mod_poly_oz_rns_t f, const fmpz_mod_poly_oz_rns_t g,
+                              const fmpz_mod_poly_oz_rns_precomp_t precomp) {
+  const size_t n = precomp->n;
+#pragma omp parallel for
+  for(size_t i=0; i<precomp->k; i++) {
+    const mp_limb_t p = precomp->p[i];
+    for(size_t j=i*n; j<(i+1)*n; j++)
+      h->coeffs[j] = n_submod(f->coeffs[j], g->coeffs[j], p);
+  }
+}
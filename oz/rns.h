@@ -0,0 +1,233 @@
+/**
+   @file rns.h
+   @brief Computing in the NTT domain modulo a product of word-sized primes.
+
+   Let @f$q = \prod_{i=0}^{k-1} p_i@f$ where each @f$p_i < 2^{60}@f$ is a prime with @f$p_i \equiv 1
+   \bmod 2n@f$. Then an element of @f$\ZZ_q[x]/\ideal{x^n+1}@f$ in the NTT domain is stored as $k$
+   vectors of residues modulo $p_i$ (residue number system). Additions and multiplications are loops
+   over machine words and we only lift back to @f$\ZZ_q@f$ using the CRT when leaving the NTT domain.
+
+   The NTT domain agrees coefficient-wise with the one used in `ntt.h`, i.e. for @f$φ \in \ZZ_q@f$
+   with @f$φ \equiv ψ_i \bmod p_i@f$ both representations hold @f$f(φ^{2\mathrm{brv}(j)+1})@f$ at
+   index $j$.
+ */
+
+#ifndef RNS_H
+#define RNS_H
+
+#include <stdint.h>
+#include <flint/flint.h>
+#include <flint/ulong_extras.h>
+#include <flint/fmpz.h>
+#include <flint/fmpz_poly.h>
+#include <flint/fmpz_mod_poly.h>
+#include <oz/ntt.h>
+
+/**
+   @brief Bit size of primes $p_i$.
+
+   We leave some headroom below 64 bits so that lazy additions do not overflow and Shoup
+   multiplication only needs one correction step.
+*/
+
+#define OZ_RNS_PRIME_BITS 60
+
+/**
+   @brief Pre-computed data for the RNS number-theoretic transform
+*/
+
+struct fmpz_mod_poly_oz_rns_precomp_struct {
+  size_t n;                   //!< dimension, must be a power of two
+  size_t k;                   //!< number of primes
+  mp_limb_t *p;               //!< primes $p_i ≡ 1 \\bmod 2n$
+  mp_limb_t *p_inv;           //!< pre-inverses of $p_i$ as computed by `n_preinvert_limb()`
+  mp_limb_t *phi_br;          //!< $ψ_i^{\mathrm{brv}(j)}$ at index $i·n+j$ where $ψ_i$ is a primitive $2n$-th root of unity mod $p_i$, cf. `fmpz_mod_poly_oz_ntt_precomp_t`
+  mp_limb_t *phi_br_shoup;    //!< Shoup pre-computation for `phi_br`
+  mp_limb_t *phi_inv_br;      //!< $ψ_i^{-\mathrm{brv}(j)}$ at index $i·n+j$, with $n^{-1}$ folded into $j=1$
+  mp_limb_t *phi_inv_br_shoup; //!< Shoup pre-computation for `phi_inv_br`
+  mp_limb_t *n_inv;           //!< $n^{-1} \bmod p_i$ at index $i$
+  mp_limb_t *n_inv_shoup;     //!< Shoup pre-computation for `n_inv`
+  fmpz_t q;                   //!< $q = \\prod p_i$
+  fmpz_t phi_q;               //!< $φ \\in \\ZZ_q$ with $φ ≡ ψ_i \\bmod p_i$
+  fmpz *m;                    //!< $q/p_i$ at index $i$
+  mp_limb_t *m_inv;           //!< $(q/p_i)^{-1} \\bmod p_i$ at index $i$
+};
+
+/**
+   @brief Pre-computed data for the RNS number-theoretic transform
+*/
+
+typedef struct fmpz_mod_poly_oz_rns_precomp_struct fmpz_mod_poly_oz_rns_precomp_t[1];
+
+/**
+   @brief An element of @f$\ZZ_q[x]/\ideal{x^n+1}@f$ in the NTT domain as residues modulo $p_i$.
+*/
+
+struct fmpz_mod_poly_oz_rns_struct {
+  mp_limb_t *coeffs;          //!< residues modulo $p_i$ at indices $i·n,…,i·n+n-1$
+  size_t n;                   //!< dimension
+  size_t k;                   //!< number of primes
+};
+
+/**
+   @brief An element of @f$\ZZ_q[x]/\ideal{x^n+1}@f$ in the NTT domain as residues modulo $p_i$.
+*/
+
+typedef struct fmpz_mod_poly_oz_rns_struct fmpz_mod_poly_oz_rns_t[1];
+
+/**
+   @brief Compute $r = a·w \\bmod p$ given $w' = \\lfloor w·2^{64}/p \\rfloor$.
+
+   @param a    integer $0 ≤ a < p$
+   @param w    integer $0 ≤ w < p$
+   @param w_   Shoup pre-computation for $w$
+   @param p    modulus $p < 2^{63}$
+*/
+
+static inline mp_limb_t n_oz_mulmod_shoup(const mp_limb_t a, const mp_limb_t w, const mp_limb_t w_, const mp_limb_t p) {
+  mp_limb_t hi, lo;
+  umul_ppmm(hi, lo, a, w_);
+  mp_limb_t r = a*w - hi*p;
+  if (r >= p)
+    r -= p;
+  return r;
+}
+
+/**
+   @brief Return $\\lfloor w·2^{64}/p \\rfloor$ for $w < p$.
+*/
+
+static inline mp_limb_t n_oz_mulmod_shoup_precomp(const mp_limb_t w, const mp_limb_t p) {
+  mp_limb_t q, r;
+  unsigned int norm;
+  count_leading_zeros(norm, p);
+  /* udiv_qrnnd requires a normalised divisor, w·2^64/p = (w·2^norm)·2^64/(p·2^norm) */
+  udiv_qrnnd(q, r, w<<norm, UWORD(0), p<<norm);
+  (void)r;
+  return q;
+}
+
+/**
+   @brief Set $q$ to a product of primes $p_i < 2^{60}$ with $p_i ≡ 1 \\bmod 2n$ with at least `bits` bits.
+
+   The primes are chosen deterministically, largest first, so `fmpz_mod_poly_oz_rns_precomp_init()`
+   can recover them from $q$.
+*/
+
+void fmpz_mod_poly_oz_rns_modulus(fmpz_t q, const size_t n, const size_t bits);
+
+/**
+   @brief Pre-compute RNS NTT data for $\\ZZ_q[x]/\\ideal{x^n+1}$.
+
+   @param op   uninitialised pre-computation
+   @param n    dimension, must be a power of two
+   @param q    modulus as output by `fmpz_mod_poly_oz_rns_modulus()`
+
+   Aborts if $q$ is not of the form produced by `fmpz_mod_poly_oz_rns_modulus()`.
+*/
+
+void fmpz_mod_poly_oz_rns_precomp_init(fmpz_mod_poly_oz_rns_precomp_t op, const size_t n, const fmpz_t q);
+
+/**
+   @brief Clear pre-computed data.
+*/
+
+void fmpz_mod_poly_oz_rns_precomp_clear(fmpz_mod_poly_oz_rns_precomp_t op);
+
+/**
+   @brief Pre-compute NTT data modulo $q$ consistent with `rns`.
+
+   Encodings computed using `op` can be converted to and from RNS encodings coefficient-wise.
+*/
+
+void fmpz_mod_poly_oz_ntt_precomp_init_rns(fmpz_mod_poly_oz_ntt_precomp_t op, const fmpz_mod_poly_oz_rns_precomp_t rns);
+
+/**
+   @brief Initialise `op` to zero.
+*/
+
+void fmpz_mod_poly_oz_rns_init(fmpz_mod_poly_oz_rns_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp);
+
+/**
+   @brief Clear `op`.
+*/
+
+void fmpz_mod_poly_oz_rns_clear(fmpz_mod_poly_oz_rns_t op);
+
+/**
+   @brief Set `rop` to `op`.
+*/
+
+void fmpz_mod_poly_oz_rns_set(fmpz_mod_poly_oz_rns_t rop, const fmpz_mod_poly_oz_rns_t op);
+
+/**
+   @brief Compute @f$\mbox{rop} = \NTT{\mbox{op}}@f$ using `precomp` for @f$\mbox{op} \in \ZZ[x]/\ideal{x^n+1}@f$.
+*/
+
+void fmpz_mod_poly_oz_rns_enc_fmpz_poly(fmpz_mod_poly_oz_rns_t rop, const fmpz_poly_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp);
+
+/**
+   @brief Compute @f$\mbox{rop} = \NTT{\mbox{op}}@f$ using `precomp` for @f$\mbox{op} \in \ZZ_q[x]/\ideal{x^n+1}@f$.
+*/
+
+void fmpz_mod_poly_oz_rns_enc(fmpz_mod_poly_oz_rns_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp);
+
+/**
+   @brief Compute @f$\mbox{rop} = \INTT{\mbox{op}}@f$ using `precomp`.
+
+   This is the only place where we apply the CRT.
+*/
+
+void fmpz_mod_poly_oz_rns_dec(fmpz_mod_poly_t rop, const fmpz_mod_poly_oz_rns_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp);
+
+/**
+   @brief Convert NTT representation modulo $q$ to residues modulo $p_i$.
+*/
+
+void fmpz_mod_poly_oz_rns_set_fmpz_mod_poly(fmpz_mod_poly_oz_rns_t rop, const fmpz_mod_poly_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp);
+
+/**
+   @brief Convert residues modulo $p_i$ to NTT representation modulo $q$ using the CRT.
+*/
+
+void fmpz_mod_poly_oz_rns_get_fmpz_mod_poly(fmpz_mod_poly_t rop, const fmpz_mod_poly_oz_rns_t op, const fmpz_mod_poly_oz_rns_precomp_t precomp);
+
+/**
+   @brief Compute $h = \\NTT{f' · g'}$ from $f = \\NTT{f'}$ and $g = \\NTT{g'}$.
+*/
+
+void fmpz_mod_poly_oz_rns_mul(fmpz_mod_poly_oz_rns_t h, const fmpz_mod_poly_oz_rns_t f, const fmpz_mod_poly_oz_rns_t g,
+                              const fmpz_mod_poly_oz_rns_precomp_t precomp);
+
+/**
+   @brief Compute $h = \\NTT{f' + g'}$ from $f = \\NTT{f'}$ and $g = \\NTT{g'}$.
+*/
+
+void fmpz_mod_poly_oz_rns_add(fmpz_mod_poly_oz_rns_t h, const fmpz_mod_poly_oz_rns_t f, const fmpz_mod_poly_oz_rns_t g,
+                              const fmpz_mod_poly_oz_rns_precomp_t precomp);
+
+/**
+   @brief Compute $h = \\NTT{f' - g'}$ from $f = \\NTT{f'}$ and $g = \\NTT{g'}$.
+*/
+
+void fmpz_mod_poly_oz_rns_sub(fmpz_mod_poly_oz_rns_t h, const fmpz_mod_poly_oz_rns_t f, const fmpz_mod_poly_oz_rns_t g,
+                              const fmpz_mod_poly_oz_rns_precomp_t precomp);
+
+/**
+   @brief In-place negacyclic Cooley-Tukey transform modulo $p$, output in bit-reversed order.
+
+   @see _fmpz_vec_oz_ntt_ct
+*/
+
+void _nmod_vec_oz_ntt_ct(mp_limb_t *a, const mp_limb_t *phi_br, const mp_limb_t *phi_br_shoup, const size_t n, const mp_limb_t p);
+
+/**
+   @brief In-place negacyclic Gentleman-Sande transform modulo $p$ of input in bit-reversed order, scaled by $n^{-1}$.
+
+   @see _fmpz_vec_oz_ntt_gs
+*/
+
+void _nmod_vec_oz_ntt_gs(mp_limb_t *a, const mp_limb_t *phi_inv_br, const mp_limb_t *phi_inv_br_shoup,
+                         const mp_limb_t n_inv, const mp_limb_t n_inv_shoup, const size_t n, const mp_limb_t p);
+
+#endif /* RNS_H */
@@ -253,6 +253,87 @@ int test_dist_rot_identity(long ncols, double sigma, size_t ntrials, aes_randsta
     return 1;
 }
 
+int test_sample_D1(long ncols, mpfr_prec_t prec, size_t ntrials, aes_randstate_t state) {
+  assert(ncols>0);
+  assert(ntrials>0);
+
+  fmpq_poly_t x;  fmpq_poly_init(x);
+  mpq_t xi_q;  mpq_init(xi_q);
+
+  double mean = 0.0;
+  double var = 0.0;
+  const double N = (double)ncols*ntrials;
+  for(size_t t=0; t<ntrials; t++) {
+    fmpq_poly_sample_D1(x, ncols, prec, state);
+    for(long i=0; i<ncols; i++) {
+      fmpq_poly_get_coeff_mpq(xi_q, x, i);
+      const double xi = mpq_get_d(xi_q);
+      mean += xi/N;
+      var += xi*xi/N;
+    }
+  }
+
+  printf("D1::            n: %4ld,   prec: %6ld :: E[x_i]·sqrt(N): %6.2lf, E[x_i^2]: %6.4lf",
+         ncols, (long)prec, mean*sqrt(N), var);
+
+  mpq_clear(xi_q);
+  fmpq_poly_clear(x);
+  if (fabs(mean*sqrt(N)) < 5.0 && fabs(var - 1.0) < 5.0*sqrt(2.0/N))
+    return 0;
+  else
+    return 1;
+}
+
+int test_disc_gauss_rounding(long ncols, double sigma, size_t ntrials, aes_randstate_t state) {
+  assert(ncols>0);
+  assert(sigma>0);
+  assert(ntrials>0);
+
+  mpfr_t sigma_;
+  mpfr_init2(sigma_, 80);
+  mpfr_set_d(sigma_, sigma, MPFR_RNDN);
+
+  /* a different centre c_i = i·(1 + 1/n) - n/2 for each coefficient, the sampler is re-centred per coefficient */
+  fmpq_poly_t x;  fmpq_poly_init(x);
+  fmpq_t c;  fmpq_init(c);
+  double *centres = (double*)calloc(ncols, sizeof(double));
+  for(long i=0; i<ncols; i++) {
+    fmpq_set_si(c, i*(ncols+1) - ncols*ncols/2, ncols);
+    fmpq_poly_set_coeff_fmpq(x, i, c);
+    centres[i] = (double)(i*(ncols+1) - ncols*ncols/2)/ncols;
+  }
+
+  double *mean = (double*)calloc(ncols, sizeof(double));
+  fmpz_poly_t v;  fmpz_poly_init(v);
+  fmpz_t vi;  fmpz_init(vi);
+  for(size_t t=0; t<ntrials; t++) {
+    fmpz_poly_disc_gauss_rounding(v, x, sigma_, state);
+    for(long i=0; i<ncols; i++) {
+      fmpz_poly_get_coeff_fmpz(vi, v, i);
+      mean[i] += fmpz_get_d(vi)/ntrials;
+    }
+  }
+
+  double err = 0.0;
+  for(long i=0; i<ncols; i++)
+    err = fmax(err, fabs(mean[i] - centres[i]));
+
+  printf("rounding::      n: %4ld, log(σ): %6.2lf :: max|E[v_i] - c_i|·sqrt(N)/σ: %6.2lf",
+         ncols, log2(sigma), err*sqrt(ntrials)/sigma);
+
+  fmpz_clear(vi);
+  fmpz_poly_clear(v);
+  free(mean);
+  free(centres);
+  fmpq_clear(c);
+  fmpq_poly_clear(x);
+  mpfr_clear(sigma_);
+  if (err*sqrt(ntrials)/sigma < 5.0)
+    return 0;
+  else
+    return 1;
+}
+
 int test_dist_rot_inlattice(long ncols, double sigma, double sigma_p, size_t ntrials, aes_randstate_t state, int gpv) {
   assert(ncols>0);
   assert(sigma>0);
@@ -453,6 +534,12 @@ int main(int argc, char *argv[]) {
   status += test_dgsl_run( test_dist_rot_identity( 128, 100000000.0, 1<<10, randstate) );
   printf("\n");
 
+  status += test_dgsl_run( test_sample_D1(  64,  53, 1<<10, randstate) );
+  status += test_dgsl_run( test_sample_D1(  64, 160, 1<<10, randstate) );
+  status += test_dgsl_run( test_disc_gauss_rounding(  16,    10.0, 1<<10, randstate) );
+  status += test_dgsl_run( test_disc_gauss_rounding(  64,  1000.0, 1<<10, randstate) );
+  printf("\n");
+
   status += test_dgsl_run( test_dist_rot_inlattice(     16,  1000.0,    100000.0, 1<<10, randstate, 0) );
   status += test_dgsl_run( test_dist_rot_inlattice(     32, 10000.0,  10000000.0, 1<<10, randstate, 0) );
   status += test_dgsl_run( test_dist_rot_inlattice(     64,  1000.0,  10000000.0, 1<<10, randstate, 0) );
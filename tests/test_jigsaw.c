@@ -1,3 +1,5 @@
+#include <unistd.h>
+#include <sys/stat.h>
 #include <gghlite/gghlite.h>
 #include <gghlite/gghlite-internals.h>
 
@@ -96,6 +98,98 @@ int test_jigsaw_indices(const size_t lambda, const size_t kappa, const size_t ga
     return status;
 }
 
+/**
+ * Encoder under test: set rop[k] to a level-1 encoding of f[k] in the groups selected by group[k]
+ */
+typedef void (*test_encode_t)(gghlite_enc_t *rop, gghlite_sk_t self, const gghlite_clr_t *f,
+                              const size_t len, int **group);
+
+static void test_encode_single(gghlite_enc_t *rop, gghlite_sk_t self, const gghlite_clr_t *f,
+                               const size_t len, int **group) {
+    for(size_t k=0; k<len; k++)
+        gghlite_enc_set_gghlite_clr(rop[k], self, f[k], 1, group[k], 1);
+}
+
+static void test_encode_many(gghlite_enc_t *rop, gghlite_sk_t self, const gghlite_clr_t *f,
+                             const size_t len, int **group) {
+    gghlite_enc_set_gghlite_clr_many(rop, self, f, len, 1, group, 1);
+}
+
+/**
+ * Set u[k] to an encoding with `encode` of a random a_k ∈ Z_p in group k (group 0 if symmetric),
+ * where p is the norm of <g>, and acc to ∏ a_k mod p if acc is not NULL.
+ */
+static void test_jigsaw_sample(gghlite_enc_t *u, fmpz_t acc, gghlite_sk_t self, test_encode_t encode,
+                               aes_randstate_t randstate) {
+    const size_t kappa = self->params->kappa;
+
+    fmpz_t p; fmpz_init(p);
+    fmpz_poly_oz_ideal_norm(p, self->g, self->params->n, 0);
+
+    fmpz_t a;  fmpz_init(a);
+    if (acc)
+        fmpz_set_ui(acc, 1);
+
+    gghlite_clr_t e[kappa];
+    int *group[kappa];
+    for(size_t k=0; k<kappa; k++) {
+        fmpz_randm_aes(a, randstate, p);
+        if (acc) {
+            fmpz_mul(acc, acc, a);
+            fmpz_mod(acc, acc, p);
+        }
+        gghlite_clr_init(e[k]);
+        fmpz_poly_set_coeff_fmpz(e[k], 0, a);
+        group[k] = (int*)calloc(self->params->gamma, sizeof(int));
+        group[k][(gghlite_sk_is_symmetric(self)) ? 0 : k] = 1;
+    }
+
+    encode(u, self, (const gghlite_clr_t *)e, kappa, group);
+
+    for(size_t k=0; k<kappa; k++) {
+        free(group[k]);
+        gghlite_clr_clear(e[k]);
+    }
+    fmpz_clear(a);
+    fmpz_clear(p);
+}
+
+/**
+ * Encode κ random elements with `encode` as in test_jigsaw_sample(), set `left` to the product of
+ * their encodings and `zero` to the encoding of the product of the clear elements times ∏ z_i^{-1}
+ * minus `left`. Return the number of failed zero-tests using `zt`: `left` must fail, `zero` must pass.
+ */
+static int test_jigsaw_product(gghlite_enc_t left, gghlite_enc_t zero, gghlite_sk_t self, test_encode_t encode,
+                               const gghlite_params_t zt, aes_randstate_t randstate) {
+    const size_t kappa = self->params->kappa;
+
+    gghlite_enc_t u[kappa];
+    for(size_t k=0; k<kappa; k++)
+        gghlite_enc_init(u[k], self->params);
+    fmpz_t acc;  fmpz_init(acc);
+    test_jigsaw_sample(u, acc, self, encode, randstate);
+
+    gghlite_enc_set_ui0(left, 1, self->params);
+    for(size_t k=0; k<kappa; k++)
+        gghlite_enc_mul(left, self->params, left, u[k]);
+
+    gghlite_clr_t e;  gghlite_clr_init(e);
+    fmpz_poly_set_coeff_fmpz(e, 0, acc);
+    gghlite_enc_set_gghlite_clr0(zero, self, e);
+    for(size_t k=0; k<kappa; k++)
+        gghlite_enc_mul(zero, self->params, zero, self->z_inv[(gghlite_sk_is_symmetric(self)) ? 0 : k]);
+    gghlite_enc_sub(zero, self->params, zero, left);
+
+    int status = gghlite_enc_is_zero(zt, left);
+    status += 1 - gghlite_enc_is_zero(zt, zero);
+
+    gghlite_clr_clear(e);
+    fmpz_clear(acc);
+    for(size_t k=0; k<kappa; k++)
+        gghlite_enc_clear(u[k]);
+    return status;
+}
+
 int test_jigsaw(const size_t lambda, const size_t kappa, int symmetric, aes_randstate_t randstate) {
 
     printf("λ: %4zu, κ: %2zu, symmetric: %d …", lambda, kappa, symmetric);
@@ -160,6 +254,24 @@ int test_jigsaw(const size_t lambda, const size_t kappa, int symmetric, aes_rand
     gghlite_enc_sub(rght, self->params, rght, left);
     int status = 1 - gghlite_enc_is_zero(self->params, rght);
 
+    /* workspace variant agrees, also on a non-zero product */
+    gghlite_enc_ws_t ws;
+    gghlite_enc_ws_init(ws, self->params);
+    status += 1 - gghlite_enc_is_zero_ws(self->params, rght, ws);
+    status += gghlite_enc_is_zero_ws(self->params, left, ws);
+    gghlite_enc_ws_clear(ws);
+
+    gghlite_enc_t batch[2];
+    int results[2];
+    gghlite_enc_init(batch[0], self->params);
+    gghlite_enc_init(batch[1], self->params);
+    gghlite_enc_set(batch[0], rght);
+    gghlite_enc_set(batch[1], left);
+    gghlite_enc_is_zero_batch(results, self->params, (const gghlite_enc_t *)batch, 2);
+    status += (1 - results[0]) + results[1];
+    gghlite_enc_clear(batch[0]);
+    gghlite_enc_clear(batch[1]);
+
     for(size_t i=0; i<kappa; i++) {
         fmpz_clear(a[i]);
         gghlite_clr_clear(e[i]);
@@ -180,6 +292,551 @@ int test_jigsaw(const size_t lambda, const size_t kappa, int symmetric, aes_rand
     return status;
 }
 
+int test_jigsaw_rns(const size_t lambda, const size_t kappa, aes_randstate_t randstate) {
+
+    printf("λ: %4zu, κ: %2zu,       rns: 1 …", lambda, kappa);
+
+    gghlite_sk_t self;
+    gghlite_flag_t flags = GGHLITE_FLAGS_QUIET | GGHLITE_FLAGS_RNS;
+    gghlite_jigsaw_init(self, lambda, kappa, flags, randstate);
+
+    fmpz_t p; fmpz_init(p);
+    fmpz_poly_oz_ideal_norm(p, self->g, self->params->n, 0);
+
+    fmpz_t a[kappa];
+    fmpz_t acc;  fmpz_init(acc);
+    fmpz_set_ui(acc, 1);
+
+    for(size_t k=0; k<kappa; k++) {
+        fmpz_init(a[k]);
+        fmpz_randm_aes(a[k], randstate, p);
+        fmpz_mul(acc, acc, a[k]);
+        fmpz_mod(acc, acc, p);
+    }
+
+    gghlite_clr_t e;  gghlite_clr_init(e);
+    gghlite_enc_t u;  gghlite_enc_init(u, self->params);
+    gghlite_enc_rns_t t;  gghlite_enc_rns_init(t, self->params);
+
+    gghlite_enc_rns_t left;
+    gghlite_enc_rns_init(left, self->params);
+    gghlite_enc_set_ui0(u, 1, self->params);
+    gghlite_enc_rns_set_gghlite_enc(left, self->params, u);
+
+    for(size_t k=0; k<kappa; k++) {
+        fmpz_poly_zero(e);
+        fmpz_poly_set_coeff_fmpz(e, 0, a[k]);
+		int group[GAMMA];
+		memset(group, 0, GAMMA * sizeof(int));
+		group[k] = 1;
+        gghlite_enc_set_gghlite_clr(u, self, e, 1, group, 1);
+        gghlite_enc_rns_set_gghlite_enc(t, self->params, u);
+        gghlite_enc_rns_mul(left, self->params, left, t);
+    }
+
+    gghlite_enc_rns_t rght;
+    gghlite_enc_rns_init(rght, self->params);
+
+    fmpz_poly_zero(e);
+    fmpz_poly_set_coeff_fmpz(e, 0, acc);
+    gghlite_enc_set_gghlite_clr0(u, self, e);
+    gghlite_enc_rns_set_gghlite_enc(rght, self->params, u);
+
+    for(size_t k=0; k<kappa; k++) {
+        gghlite_enc_rns_set_gghlite_enc(t, self->params, self->z_inv[k]);
+        gghlite_enc_rns_mul(rght, self->params, rght, t);
+    }
+
+    gghlite_enc_rns_sub(rght, self->params, rght, left);
+    int status = 1 - gghlite_enc_rns_is_zero(self->params, rght);
+
+    /* a non-zero product must not pass */
+    status += gghlite_enc_rns_is_zero(self->params, left);
+
+    /* both representations agree */
+    gghlite_enc_set_gghlite_enc_rns(u, self->params, rght);
+    status += 1 - gghlite_enc_is_zero(self->params, u);
+
+    for(size_t i=0; i<kappa; i++)
+        fmpz_clear(a[i]);
+
+    gghlite_enc_rns_clear(left);
+    gghlite_enc_rns_clear(rght);
+    gghlite_enc_rns_clear(t);
+    gghlite_enc_clear(u);
+    gghlite_clr_clear(e);
+    fmpz_clear(acc);
+    fmpz_clear(p);
+    gghlite_sk_clear(self, 1);
+
+    if (status == 0)
+        printf(" PASS\n");
+    else
+        printf(" FAIL\n");
+
+    return status;
+}
+
+int test_jigsaw_many(const size_t lambda, const size_t kappa, aes_randstate_t randstate) {
+
+    printf("λ: %4zu, κ: %2zu,      many: 1 …", lambda, kappa);
+
+    gghlite_sk_t self;
+    gghlite_flag_t flags = GGHLITE_FLAGS_QUIET;
+    gghlite_jigsaw_init(self, lambda, kappa, flags, randstate);
+
+    gghlite_enc_t u[kappa];
+    gghlite_enc_t v[kappa];
+    for(size_t k=0; k<kappa; k++) {
+        gghlite_enc_init(u[k], self->params);
+        gghlite_enc_init(v[k], self->params);
+    }
+    test_jigsaw_sample(u, NULL, self, test_encode_single, randstate);
+    test_jigsaw_sample(v, NULL, self, test_encode_single, randstate);
+
+    gghlite_enc_t left;  gghlite_enc_init(left, self->params);
+    gghlite_enc_t rght;  gghlite_enc_init(rght, self->params);
+    gghlite_enc_t tmp;   gghlite_enc_init(tmp, self->params);
+
+    /* product */
+    gghlite_enc_set(left, u[0]);
+    for(size_t k=1; k<kappa; k++)
+        gghlite_enc_mul(left, self->params, left, u[k]);
+    gghlite_enc_mul_many(rght, self->params, (const gghlite_enc_t *)u, kappa);
+    gghlite_enc_sub(rght, self->params, rght, left);
+    int status = !fmpz_mod_poly_is_zero(rght);
+
+    /* inner product */
+    gghlite_enc_mul(left, self->params, u[0], v[0]);
+    for(size_t k=1; k<kappa; k++) {
+        gghlite_enc_mul(tmp, self->params, u[k], v[k]);
+        gghlite_enc_add(left, self->params, left, tmp);
+    }
+    gghlite_enc_inner_product(rght, self->params, (const gghlite_enc_t *)u, (const gghlite_enc_t *)v, kappa);
+    gghlite_enc_sub(rght, self->params, rght, left);
+    status += !fmpz_mod_poly_is_zero(rght);
+
+    /* unreduced accumulator, once with the default headroom and once forcing reductions */
+    gghlite_enc_acc_t acc;
+    gghlite_enc_acc_init(acc, self->params);
+    for(int force=0; force<2; force++) {
+        gghlite_enc_acc_zero(acc);
+        if (force)
+            acc->max_bits = 2*fmpz_sizeinbase(self->params->q, 2) + 1;
+        for(size_t k=0; k<kappa; k++) {
+            gghlite_enc_acc_addmul(acc, self->params, u[k], v[k]);
+            gghlite_enc_acc_add(acc, self->params, u[k]);
+            gghlite_enc_acc_sub(acc, self->params, u[k]);
+            gghlite_enc_acc_addmul(acc, self->params, u[k], u[k]);
+            gghlite_enc_acc_submul(acc, self->params, u[k], u[k]);
+            status += !gghlite_enc_acc_check_bound(acc);
+        }
+        gghlite_enc_set_gghlite_enc_acc(rght, self->params, acc);
+        gghlite_enc_sub(rght, self->params, rght, left);
+        status += !fmpz_mod_poly_is_zero(rght);
+    }
+    gghlite_enc_acc_clear(acc);
+
+    /* contiguous limb encodings */
+    gghlite_enc_limb_t lu, lv, lacc, lt;
+    gghlite_enc_limb_init(lu, self->params);
+    gghlite_enc_limb_init(lv, self->params);
+    gghlite_enc_limb_init(lacc, self->params);
+    gghlite_enc_limb_init(lt, self->params);
+    for(size_t k=0; k<kappa; k++) {
+        gghlite_enc_limb_set_gghlite_enc(lu, self->params, u[k]);
+        gghlite_enc_limb_set_gghlite_enc(lv, self->params, v[k]);
+        if (k&1) {
+            gghlite_enc_limb_addmul(lacc, self->params, lu, lv);
+        } else {
+            gghlite_enc_limb_mul(lt, self->params, lu, lv);
+            gghlite_enc_limb_add(lacc, self->params, lacc, lt);
+        }
+        gghlite_enc_limb_sub(lt, self->params, lu, lv);
+        gghlite_enc_limb_add(lt, self->params, lt, lv);
+        gghlite_enc_set_gghlite_enc_limb(rght, self->params, lt);
+        gghlite_enc_sub(rght, self->params, rght, u[k]);
+        status += !fmpz_mod_poly_is_zero(rght);
+    }
+    gghlite_enc_set_gghlite_enc_limb(rght, self->params, lacc);
+    gghlite_enc_sub(rght, self->params, rght, left);
+    status += !fmpz_mod_poly_is_zero(rght);
+    gghlite_enc_limb_clear(lu);
+    gghlite_enc_limb_clear(lv);
+    gghlite_enc_limb_clear(lacc);
+    gghlite_enc_limb_clear(lt);
+
+    for(size_t k=0; k<kappa; k++) {
+        gghlite_enc_clear(u[k]);
+        gghlite_enc_clear(v[k]);
+    }
+    gghlite_enc_clear(left);
+    gghlite_enc_clear(rght);
+    gghlite_enc_clear(tmp);
+    gghlite_sk_clear(self, 1);
+
+    if (status == 0)
+        printf(" PASS\n");
+    else
+        printf(" FAIL\n");
+
+    return status;
+}
+
+int test_jigsaw_io(const size_t lambda, const size_t kappa, int rns, aes_randstate_t randstate) {
+
+    printf("λ: %4zu, κ: %2zu,   io, rns: %d …", lambda, kappa, rns);
+
+    gghlite_sk_t self;
+    gghlite_flag_t flags = GGHLITE_FLAGS_QUIET;
+    if (rns)
+        flags |= GGHLITE_FLAGS_RNS;
+    gghlite_jigsaw_init(self, lambda, kappa, flags, randstate);
+
+    FILE *fp = tmpfile();
+    int status = gghlite_sk_save(fp, self) != 0;
+    status += gghlite_params_save(fp, self->params) != 0;
+    rewind(fp);
+
+    gghlite_sk_t other;
+    status += gghlite_sk_load(other, fp, randstate) != 0;
+    gghlite_params_t params;
+    status += gghlite_params_load(params, fp) != 0;
+    rewind(fp);
+    /* a secret key is not a set of public parameters */
+    gghlite_params_t bad;
+    status += gghlite_params_load(bad, fp) == 0;
+    fclose(fp);
+
+    if (status) {
+        printf(" FAIL\n");
+        gghlite_sk_clear(self, 1);
+        return status;
+    }
+
+    const size_t bound = (gghlite_sk_is_symmetric(self)) ? 1 : self->params->gamma;
+
+    status += !fmpz_equal(other->params->q, self->params->q);
+    status += !fmpz_equal(params->q, self->params->q);
+    status += !fmpz_equal(other->params->zt_bound, self->params->zt_bound);
+    status += mpfr_cmp(other->params->sigma_p, self->params->sigma_p) != 0;
+    status += mpfr_cmp(params->xi, self->params->xi) != 0;
+    status += !fmpz_mod_poly_equal(other->params->pzt, self->params->pzt);
+    status += !fmpz_mod_poly_equal(params->pzt, self->params->pzt);
+    status += !fmpz_mod_poly_equal(other->params->ntt->phi_br, self->params->ntt->phi_br);
+    status += !fmpz_mod_poly_equal(params->ntt->phi_inv_br, self->params->ntt->phi_inv_br);
+    status += !fmpz_poly_equal(other->g, self->g);
+    status += !fmpq_poly_equal(other->g_inv, self->g_inv);
+    status += !fmpz_poly_equal(other->h, self->h);
+    for(size_t i=0; i<bound; i++) {
+        status += !fmpz_mod_poly_equal(other->z[i], self->z[i]);
+        status += !fmpz_mod_poly_equal(other->z_inv[i], self->z_inv[i]);
+    }
+    status += !fmpq_poly_equal(other->D_g->B_inv, self->D_g->B_inv);
+    status += !fmpq_poly_equal(other->D_g->sigma_sqrt, self->D_g->sigma_sqrt);
+    status += mpfr_cmp(other->D_g->sigma, self->D_g->sigma) != 0;
+
+    /* encode with the restored key, zero-test with both copies */
+    gghlite_enc_t left;  gghlite_enc_init(left, other->params);
+    gghlite_enc_t u;  gghlite_enc_init(u, other->params);
+    status += test_jigsaw_product(left, u, other, test_encode_single, params, randstate);
+    status += gghlite_enc_is_zero(self->params, left);
+    status += 1 - gghlite_enc_is_zero(self->params, u);
+
+    /* zero-copy: zero-test straight from mapped limb arrays */
+    gghlite_enc_t ops[2];
+    gghlite_enc_init(ops[0], other->params);
+    gghlite_enc_init(ops[1], other->params);
+    gghlite_enc_set(ops[0], left);
+    gghlite_enc_set(ops[1], u);
+
+    FILE *fp_params = tmpfile();
+    FILE *fp_encs = tmpfile();
+    status += gghlite_params_save_mapped(fp_params, self->params) != 0;
+    status += gghlite_enc_save_mapped(fp_encs, self->params, (const gghlite_enc_t *)ops, 2) != 0;
+    fflush(fp_params);
+    fflush(fp_encs);
+
+    gghlite_params_map_t params_map;
+    gghlite_enc_map_t enc_map;
+    if (gghlite_params_map(params_map, fp_params) == 0) {
+        status += gghlite_enc_map(enc_map, fp_encs) != 0;
+        status += enc_map->count != 2;
+
+        fmpz_mod_poly_oz_limb_t view;
+        gghlite_enc_map_get(view, enc_map, 0);
+        status += gghlite_enc_is_zero_mapped(params_map, view);
+        fmpz_mod_poly_oz_limb_get_fmpz_mod_poly(ops[1], view);
+        status += !fmpz_mod_poly_equal(ops[1], left);
+
+        gghlite_enc_map_get(view, enc_map, 1);
+        status += 1 - gghlite_enc_is_zero_mapped(params_map, view);
+
+        gghlite_enc_unmap(enc_map);
+        gghlite_params_unmap(params_map);
+    } else {
+        /* only hosts with 64-bit little-endian limbs can map */
+        status += oz_limb_is_native();
+    }
+    fclose(fp_params);
+    fclose(fp_encs);
+    gghlite_enc_clear(ops[0]);
+    gghlite_enc_clear(ops[1]);
+
+    gghlite_enc_clear(u);
+    gghlite_enc_clear(left);
+    gghlite_params_clear(params);
+    gghlite_sk_clear(other, 1);
+    gghlite_sk_clear(self, 1);
+
+    if (status == 0)
+        printf(" PASS\n");
+    else
+        printf(" FAIL\n");
+
+    return status;
+}
+
+int test_jigsaw_add_groups(const size_t lambda, const size_t kappa, const size_t count, aes_randstate_t randstate) {
+
+    printf("λ: %4zu, κ: %2zu, add groups: %2zu …", lambda, kappa, count);
+
+    assert(count < kappa);
+    gghlite_sk_t self;
+    gghlite_jigsaw_init_gamma(self, lambda, kappa, kappa - count, GGHLITE_FLAGS_QUIET, randstate);
+
+    gghlite_enc_t pzt;
+    gghlite_enc_init(pzt, self->params);
+    gghlite_enc_set(pzt, self->params->pzt);
+
+    gghlite_sk_add_groups(self, count);
+    int status = self->params->gamma != kappa;
+
+    /* incremental p_zt agrees with multiplying in the new z_i one by one */
+    for(size_t k=kappa-count; k<kappa; k++)
+        gghlite_enc_mul(pzt, self->params, pzt, self->z[k]);
+    status += !fmpz_mod_poly_equal(pzt, self->params->pzt);
+
+    /* a product over all groups, old and new, zero-tests correctly */
+    gghlite_enc_t left;  gghlite_enc_init(left, self->params);
+    gghlite_enc_t rght;  gghlite_enc_init(rght, self->params);
+    status += test_jigsaw_product(left, rght, self, test_encode_single, self->params, randstate);
+
+    gghlite_enc_clear(rght);
+    gghlite_enc_clear(left);
+    gghlite_enc_clear(pzt);
+    gghlite_sk_clear(self, 1);
+
+    if (status == 0)
+        printf(" PASS\n");
+    else
+        printf(" FAIL\n");
+
+    return status;
+}
+
+int test_z_cache(const size_t lambda, const size_t kappa, int symmetric, aes_randstate_t randstate) {
+
+    printf("λ: %4zu, κ: %2zu, symmetric: %d, z cache …", lambda, kappa, symmetric);
+
+    gghlite_sk_t self;
+    if (symmetric)
+        gghlite_init(self, lambda, kappa, kappa, 0x0, GGHLITE_FLAGS_QUIET | GGHLITE_FLAGS_GOOD_G_INV, randstate);
+    else
+        gghlite_jigsaw_init(self, lambda, kappa, GGHLITE_FLAGS_QUIET, randstate);
+
+    fmpz_t p; fmpz_init(p);
+    fmpz_poly_oz_ideal_norm(p, self->g, self->params->n, 0);
+    fmpz_t a;  fmpz_init(a);
+    fmpz_randm_aes(a, randstate, p);
+    gghlite_clr_t e;  gghlite_clr_init(e);
+    fmpz_poly_set_coeff_fmpz(e, 0, a);
+
+    gghlite_enc_t u;  gghlite_enc_init(u, self->params);
+    gghlite_enc_t v;  gghlite_enc_init(v, self->params);
+    gghlite_enc_t w;  gghlite_enc_init(w, self->params);
+
+    int *group = (int*)calloc(self->params->gamma, sizeof(int));
+    int status = 0;
+
+    /* without re-randomisation encoding is deterministic, so the cached products must give the same
+       result as multiplying by each z_i^{-1} in turn, both on a miss and on a hit */
+    gghlite_enc_set_gghlite_clr0(w, self, e);
+    if (symmetric) {
+        group[0] = 1;
+        for(size_t k=1; k<=kappa; k++) {
+            gghlite_enc_mul(w, self->params, w, self->z_inv[0]);
+            gghlite_enc_set_gghlite_clr(u, self, e, k, group, 0);
+            gghlite_enc_set_gghlite_clr(v, self, e, k, group, 0);
+            status += !fmpz_mod_poly_equal(u, w) || !fmpz_mod_poly_equal(v, w);
+        }
+    } else {
+        for(size_t k=0; k<kappa; k+=2) {
+            group[k] = 1;
+            gghlite_enc_mul(w, self->params, w, self->z_inv[k]);
+        }
+        gghlite_enc_set_gghlite_clr(u, self, e, 1, group, 0);
+        gghlite_enc_set_gghlite_clr(v, self, e, 1, group, 0);
+        status += !fmpz_mod_poly_equal(u, w) || !fmpz_mod_poly_equal(v, w);
+        status += self->z_cache->len != (kappa > 2);
+    }
+
+    free(group);
+    gghlite_enc_clear(w);
+    gghlite_enc_clear(v);
+    gghlite_enc_clear(u);
+    gghlite_clr_clear(e);
+    fmpz_clear(a);
+    fmpz_clear(p);
+    gghlite_sk_clear(self, 1);
+
+    if (status == 0)
+        printf(" PASS\n");
+    else
+        printf(" FAIL\n");
+
+    return status;
+}
+
+int test_enc_many(const size_t lambda, const size_t kappa, int symmetric, aes_randstate_t randstate) {
+
+    printf("λ: %4zu, κ: %2zu, symmetric: %d, batch encoding …", lambda, kappa, symmetric);
+
+    gghlite_sk_t self;
+    if (symmetric)
+        gghlite_init(self, lambda, kappa, kappa, 0x0, GGHLITE_FLAGS_QUIET | GGHLITE_FLAGS_GOOD_G_INV, randstate);
+    else
+        gghlite_jigsaw_init(self, lambda, kappa, GGHLITE_FLAGS_QUIET, randstate);
+
+    gghlite_clr_t e[kappa];
+    gghlite_enc_t u[kappa];
+    gghlite_enc_t v;  gghlite_enc_init(v, self->params);
+    int *group[kappa];
+
+    for(size_t k=0; k<kappa; k++) {
+        gghlite_clr_init(e[k]);
+        fmpz_poly_set_coeff_ui(e[k], 0, k+2);
+        gghlite_enc_init(u[k], self->params);
+        group[k] = (int*)calloc(self->params->gamma, sizeof(int));
+        group[k][(gghlite_sk_is_symmetric(self)) ? 0 : k] = 1;
+    }
+
+    int status = 0;
+
+    /* without re-randomisation the batch encoder must agree with the single element encoder */
+    gghlite_enc_set_gghlite_clr_many(u, self, (const gghlite_clr_t *)e, kappa, 1, group, 0);
+    for(size_t k=0; k<kappa; k++) {
+        gghlite_enc_set_gghlite_clr(v, self, e[k], 1, group[k], 0);
+        status += !fmpz_mod_poly_equal(u[k], v);
+    }
+
+    /* with re-randomisation the product must still zero-test against the product of the clear elements */
+    gghlite_enc_t left;  gghlite_enc_init(left, self->params);
+    status += test_jigsaw_product(left, v, self, test_encode_many, self->params, randstate);
+
+    gghlite_enc_clear(left);
+    for(size_t k=0; k<kappa; k++) {
+        free(group[k]);
+        gghlite_enc_clear(u[k]);
+        gghlite_clr_clear(e[k]);
+    }
+    gghlite_enc_clear(v);
+    gghlite_sk_clear(self, 1);
+
+    if (status == 0)
+        printf(" PASS\n");
+    else
+        printf(" FAIL\n");
+
+    return status;
+}
+
+int test_D_g_pool(const size_t lambda, const size_t kappa, const size_t size, const size_t low,
+                  aes_randstate_t randstate) {
+
+    printf("λ: %4zu, κ: %2zu, D_g pool: %3zu/%3zu …", lambda, kappa, low, size);
+
+    gghlite_sk_t self;
+    gghlite_jigsaw_init(self, lambda, kappa, GGHLITE_FLAGS_QUIET, randstate);
+    gghlite_sk_set_D_g_pool(self, size, low);
+
+    gghlite_enc_t left;  gghlite_enc_init(left, self->params);
+    gghlite_enc_t rght;  gghlite_enc_init(rght, self->params);
+
+    int status = 0;
+
+    /* draw more perturbations than the pool holds so that it is refilled a few times */
+    for(size_t round=0; round<(2*size)/kappa+1; round++)
+        status += test_jigsaw_product(left, rght, self, test_encode_single, self->params, randstate);
+
+    gghlite_enc_clear(rght);
+    gghlite_enc_clear(left);
+    gghlite_sk_clear(self, 1);
+
+    if (status == 0)
+        printf(" PASS\n");
+    else
+        printf(" FAIL\n");
+
+    return status;
+}
+
+int test_params_cache(const size_t lambda, const size_t kappa, gghlite_flag_t flags) {
+
+    printf("λ: %4zu, κ: %2zu, cache, flags: 0x%02x …", lambda, kappa, flags);
+
+    char path[] = "/tmp/gghlite_params_cache_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        printf(" FAIL\n");
+        return 1;
+    }
+    close(fd);
+
+    gghlite_params_t self;
+    gghlite_jigsaw_params_init(self, lambda, kappa, kappa, flags | GGHLITE_FLAGS_QUIET);
+
+    int status = gghlite_params_cache_add(path, self) != 0;
+    struct stat st0, st1;
+    stat(path, &st0);
+    /* adding the same key again is a no-op */
+    status += gghlite_params_cache_add(path, self) != 0;
+    stat(path, &st1);
+    status += st0.st_size != st1.st_size;
+
+    /* verbosity is not part of the key, the re-randomisation mask is */
+    gghlite_params_t other;
+    gghlite_params_initzero(other, lambda, kappa, kappa);
+    other->rerand_mask = self->rerand_mask;
+    other->flags = self->flags | GGHLITE_FLAGS_VERBOSE;
+    status += gghlite_params_cache_get(other, path) != 0;
+    status += other->n != self->n;
+    status += !fmpz_equal(other->q, self->q);
+    status += mpfr_cmp(other->xi, self->xi) != 0;
+    status += mpfr_cmp(other->sigma_p, self->sigma_p) != 0;
+    status += mpfr_cmp(other->sigma_s, self->sigma_s) != 0;
+    other->rerand_mask = 0x1;
+    status += gghlite_params_cache_get(other, path) == 0;
+    gghlite_params_clear(other);
+
+    /* gghlite_params_init_gamma() consults the cache */
+    setenv(GGHLITE_PARAMS_CACHE_ENV, path, 1);
+    gghlite_jigsaw_params_init(other, lambda, kappa, kappa, flags | GGHLITE_FLAGS_QUIET);
+    unsetenv(GGHLITE_PARAMS_CACHE_ENV);
+    status += !fmpz_equal(other->q, self->q);
+    status += !fmpz_equal(other->zt_bound, self->zt_bound);
+    gghlite_params_clear(other);
+
+    gghlite_params_clear(self);
+    remove(path);
+
+    if (status == 0)
+        printf(" PASS\n");
+    else
+        printf(" FAIL\n");
+
+    return status;
+}
 
 int main(int argc, char *argv[]) {
     aes_randstate_t randstate;
@@ -195,6 +852,28 @@ int main(int argc, char *argv[]) {
     status += test_jigsaw(20, 3, 0, randstate);
     status += test_jigsaw(20, 4, 0, randstate);
 
+    status += test_jigsaw_rns(20, 2, randstate);
+    status += test_jigsaw_rns(20, 4, randstate);
+
+    status += test_jigsaw_many(20, 2, randstate);
+    status += test_jigsaw_many(20, 4, randstate);
+
+    status += test_jigsaw_io(20, 2, 0, randstate);
+    status += test_jigsaw_io(20, 3, 1, randstate);
+
+    status += test_jigsaw_add_groups(20, 4, 2, randstate);
+
+    status += test_z_cache(20, 3, 1, randstate);
+    status += test_z_cache(20, 4, 0, randstate);
+
+    status += test_enc_many(20, 3, 1, randstate);
+    status += test_enc_many(20, 4, 0, randstate);
+
+    status += test_D_g_pool(20, 4, 8, 2, randstate);
+
+    status += test_params_cache(20, 2, GGHLITE_FLAGS_DEFAULT);
+    status += test_params_cache(20, 3, GGHLITE_FLAGS_SPARSE_Q);
+
     status += test_jigsaw_indices(20, 4, 90, randstate);
     status += test_jigsaw_indices(20, 20, 60, randstate);
 
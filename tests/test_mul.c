@@ -118,6 +118,301 @@ int test_fmpz_mod_poly_oz_mul(long n, long q_, aes_randstate_t state) {
   return !r;
 }
 
+int test_fmpz_mod_poly_oz_ntt_ws(long n, mp_bitcnt_t bits, size_t trials, aes_randstate_t state) {
+  fmpz_t q;
+  fmpz_init(q);
+  fmpz_mod_poly_oz_rns_modulus(q, n, bits);
+
+  /* q is composite, so we take φ from the RNS pre-computation */
+  fmpz_mod_poly_oz_rns_precomp_t rns;
+  fmpz_mod_poly_oz_rns_precomp_init(rns, n, q);
+  fmpz_mod_poly_oz_ntt_precomp_t precomp;
+  fmpz_mod_poly_oz_ntt_precomp_init_rns(precomp, rns);
+  fmpz_mod_poly_oz_ntt_ws_t ws;
+  fmpz_mod_poly_oz_ntt_ws_init(ws, precomp);
+
+  fmpz_mod_poly_t f;  fmpz_mod_poly_init(f, q);
+  fmpz_mod_poly_t F;  fmpz_mod_poly_init(F, q);
+  fmpz_mod_poly_t g;  fmpz_mod_poly_init(g, q);
+
+  int r = 1;
+  uint64_t t = oz_walltime(0);
+  for(size_t i=0; i<trials; i++) {
+    fmpz_mod_poly_randtest_aes(f, state, n);
+    fmpz_mod_poly_oz_ntt_enc_ws(F, f, precomp, ws);
+    fmpz_mod_poly_oz_ntt_dec_ws(g, F, precomp, ws);
+    r &= fmpz_mod_poly_equal(f, g);
+  }
+  t = oz_walltime(t);
+
+  /* index j holds f(φ^(2·brv(j)+1)), check it by Horner's rule for one random j in each of
+     (up to) 64 strata covering all n indices */
+  const fmpz *phi = precomp->phi_br->coeffs + precomp->brv[1];
+  const long strata = (n < 64) ? n : 64;
+  const long width = n/strata;
+  fmpz_t x;  fmpz_init(x);
+  fmpz_t y;  fmpz_init(y);
+  fmpz_t w;  fmpz_init_set_ui(w, width);
+  for(long k=0; k<strata; k++) {
+    fmpz_randm_aes(y, state, w);
+    const long j = k*width + fmpz_get_si(y);
+    fmpz_powm_ui(x, phi, 2*precomp->brv[j]+1, q);
+    fmpz_zero(y);
+    for(long i=fmpz_mod_poly_length(f)-1; i>=0; i--) {
+      fmpz_mul(y, y, x);
+      fmpz_add(y, y, f->coeffs + i);
+      fmpz_mod(y, y, q);
+    }
+    r &= fmpz_equal(F->coeffs + j, y);
+  }
+  fmpz_clear(w);
+  fmpz_clear(y);
+  fmpz_clear(x);
+
+  printf("n: %6ld, log(q): %6ld, trials: %4zu, enc+dec: %7.4fs ", n, fmpz_sizeinbase(q,2),
+         trials, oz_seconds(t)/trials);
+  if (r)
+    printf(" PASS\n");
+  else
+    printf(" FAIL\n");
+
+  fmpz_mod_poly_clear(g);
+  fmpz_mod_poly_clear(F);
+  fmpz_mod_poly_clear(f);
+  fmpz_mod_poly_oz_ntt_ws_clear(ws);
+  fmpz_mod_poly_oz_ntt_precomp_clear(precomp);
+  fmpz_mod_poly_oz_rns_precomp_clear(rns);
+  fmpz_clear(q);
+  return !r;
+}
+
+int test_fmpz_mod_poly_oz_ntt_inv(long n, mp_bitcnt_t bits, aes_randstate_t state) {
+  fmpz_t q;
+  fmpz_init(q);
+  fmpz_mod_poly_oz_rns_modulus(q, n, bits);
+
+  fmpz_mod_poly_t f;  fmpz_mod_poly_init(f, q);
+  fmpz_mod_poly_t h;  fmpz_mod_poly_init(h, q);
+  fmpz_t x;  fmpz_init(x);
+
+  fmpz_mod_poly_randtest_aes(f, state, n);
+  fmpz_mod_poly_set_coeff_ui(f, n-1, 1);
+
+  uint64_t t = oz_walltime(0);
+  fmpz_mod_poly_oz_ntt_inv(h, f, n);
+  t = oz_walltime(t);
+
+  int r = 1;
+  for(long i=0; i<n; i++) {
+    if (fmpz_invmod(x, f->coeffs + i, q))
+      r &= fmpz_equal(h->coeffs + i, x);
+  }
+
+  /* a zero evaluation falls back to inverting one by one */
+  fmpz_mod_poly_set_coeff_ui(f, 0, 0);
+  fmpz_mod_poly_oz_ntt_inv(f, f, n);
+  for(long i=1; i<n; i++)
+    r &= fmpz_equal(f->coeffs + i, h->coeffs + i);
+
+  printf("n: %6ld, log(q): %6ld, inv: %7.4fs ", n, fmpz_sizeinbase(q,2), oz_seconds(t));
+  if (r)
+    printf(" PASS\n");
+  else
+    printf(" FAIL\n");
+
+  fmpz_clear(x);
+  fmpz_mod_poly_clear(h);
+  fmpz_mod_poly_clear(f);
+  fmpz_clear(q);
+  return !r;
+}
+
+int test_fmpz_mod_poly_oz_mul_rns(long n, mp_bitcnt_t bits, aes_randstate_t state) {
+  fmpz_t q;
+  fmpz_init(q);
+  fmpz_mod_poly_oz_rns_modulus(q, n, bits);
+
+  fmpz_mod_poly_t f0;  fmpz_mod_poly_init(f0, q);
+  fmpz_mod_poly_t f1;  fmpz_mod_poly_init(f1, q);
+
+  fmpz_mod_poly_randtest_aes(f0, state, n);
+  while (fmpz_mod_poly_degree(f0) < n-1)
+    fmpz_mod_poly_randtest_aes(f0, state, n);
+
+  fmpz_mod_poly_randtest_aes(f1, state, n);
+  while (fmpz_mod_poly_degree(f1) < n-1)
+    fmpz_mod_poly_randtest_aes(f1, state, n);
+
+  fmpz_mod_poly_t r0, r1;
+  fmpz_mod_poly_init(r0, q);
+  fmpz_mod_poly_init(r1, q);
+
+  uint64_t t0 = oz_walltime(0);
+  fmpz_mod_poly_oz_mul(r0, f0, f1, n);
+  t0 = oz_walltime(t0);
+
+  fmpz_mod_poly_oz_rns_precomp_t rns;
+  fmpz_mod_poly_oz_rns_precomp_init(rns, n, q);
+  fmpz_mod_poly_oz_ntt_precomp_t precomp;
+  fmpz_mod_poly_oz_ntt_precomp_init_rns(precomp, rns);
+
+  /* one operand is encoded directly, the other is converted from the NTT domain mod q */
+  fmpz_mod_poly_t F1;  fmpz_mod_poly_init(F1, q);
+  fmpz_mod_poly_oz_ntt_enc(F1, f1, precomp);
+
+  fmpz_mod_poly_oz_rns_t G0, G1;
+  fmpz_mod_poly_oz_rns_init(G0, rns);
+  fmpz_mod_poly_oz_rns_init(G1, rns);
+
+  uint64_t t1 = oz_walltime(0);
+  fmpz_mod_poly_oz_rns_enc(G0, f0, rns);
+  fmpz_mod_poly_oz_rns_set_fmpz_mod_poly(G1, F1, rns);
+  fmpz_mod_poly_oz_rns_mul(G0, G0, G1, rns);
+  fmpz_mod_poly_oz_rns_dec(r1, G0, rns);
+  t1 = oz_walltime(t1);
+
+  int r = fmpz_mod_poly_equal(r0, r1);
+
+  if(!r) {
+    fmpz_mod_poly_print_pretty(r0, "x"); printf("\n");
+    fmpz_mod_poly_print_pretty(r1, "x"); printf("\n");
+  }
+  printf("n: %6ld, log(q): %6ld, k: %3zu, flint: %7.2fs, rns: %7.2fs, flint/rns: %7.2f ", n, fmpz_sizeinbase(q,2),
+         rns->k, oz_seconds(t0), oz_seconds(t1), (double)t0/(double)t1);
+  if (r)
+    printf(" PASS\n");
+  else
+    printf(" FAIL\n");
+
+  fmpz_mod_poly_oz_rns_clear(G0);
+  fmpz_mod_poly_oz_rns_clear(G1);
+  fmpz_mod_poly_oz_ntt_precomp_clear(precomp);
+  fmpz_mod_poly_oz_rns_precomp_clear(rns);
+  fmpz_mod_poly_clear(F1);
+  fmpz_mod_poly_clear(f0);
+  fmpz_mod_poly_clear(f1);
+  fmpz_mod_poly_clear(r0);
+  fmpz_mod_poly_clear(r1);
+  fmpz_clear(q);
+  return !r;
+}
+
+int test_fmpz_oz_limb_mulmod(mp_bitcnt_t bits, int special, size_t trials, aes_randstate_t state) {
+  /* odd q with the top bit set so that it takes exactly ⌈bits/64⌉ limbs */
+  fmpz_t q;  fmpz_init(q);
+  if (special) {
+    fmpz_mod_poly_oz_special_modulus(q, 1024, bits);
+  } else {
+    fmpz_randbits_aes(q, state, bits);
+    fmpz_abs(q, q);
+    fmpz_setbit(q, bits-1);
+    fmpz_setbit(q, 0);
+  }
+
+  fmpz_mod_oz_limb_ctx_t ctx;
+  fmpz_mod_oz_limb_ctx_init(ctx, q);
+  const size_t L = ctx->L;
+
+  int r = (fmpz_mod_oz_limb_ctx_is_special(ctx) == (special && L >= OZ_LIMB_SPECIAL_FACTOR));
+  mp_limb_t *scratch = (mp_limb_t*)calloc(OZ_LIMB_FMPZ_MULMOD_SCRATCH(L) + 4*L + 1, sizeof(mp_limb_t));
+  mp_limb_t *al = scratch + OZ_LIMB_FMPZ_MULMOD_SCRATCH(L), *bl = al + L, *t = bl + L;
+
+  fmpz_t a;  fmpz_init(a);
+  fmpz_t b;  fmpz_init(b);
+  fmpz_t c;  fmpz_init(c);
+  fmpz_t d;  fmpz_init(d);
+
+  for(size_t i=0; i<trials; i++) {
+    fmpz_randm_aes(a, state, q);
+    fmpz_randm_aes(b, state, q);
+    if (i == 0) {
+      fmpz_sub_ui(a, q, 1);
+      fmpz_sub_ui(b, q, 1);
+    }
+    fmpz_mul(c, a, b);
+    fmpz_mod(c, c, q);
+
+    /* Barrett */
+    fmpz_oz_limb_mulmod(d, a, b, ctx, scratch);
+    r &= fmpz_equal(c, d);
+
+    /* Montgomery: a·R · b·R · R^{-1} · R^{-1} = a·b */
+    fmpz_get_oz_limbs(al, a, L);
+    fmpz_get_oz_limbs(bl, b, L);
+    _fmpz_oz_limb_mulmod_mont(al, al, ctx->r2, ctx, scratch);
+    _fmpz_oz_limb_mulmod_mont(bl, bl, ctx->r2, ctx, scratch);
+    _fmpz_oz_limb_mulmod_mont(al, al, bl, ctx, scratch);
+    mpn_copyi(t, al, L);
+    mpn_zero(t + L, L + 1);
+    _fmpz_oz_limb_redc(al, t, ctx);
+    fmpz_set_oz_limbs(d, al, L);
+    r &= fmpz_equal(c, d);
+  }
+
+  printf("log(q): %6ld, L: %3zu, special: %d, trials: %4zu ", fmpz_sizeinbase(q,2), L,
+         fmpz_mod_oz_limb_ctx_is_special(ctx), trials);
+  if (r)
+    printf(" PASS\n");
+  else
+    printf(" FAIL\n");
+
+  fmpz_clear(d);
+  fmpz_clear(c);
+  fmpz_clear(b);
+  fmpz_clear(a);
+  free(scratch);
+  fmpz_mod_oz_limb_ctx_clear(ctx);
+  fmpz_clear(q);
+  return !r;
+}
+
+int test_fmpz_next_probabprime_ap(mp_bitcnt_t bits, const slong s, const ulong count, int coprime, aes_randstate_t state) {
+  fmpz_t q0;  fmpz_init(q0);
+  fmpz_randbits_aes(q0, state, bits);
+  fmpz_abs(q0, q0);
+  fmpz_setbit(q0, bits-1);
+  if (coprime) {
+    fmpz_setbit(q0, 0);
+  } else {
+    /* 3 divides q0 and s, i.e. every candidate */
+    fmpz_sub_ui(q0, q0, fmpz_fdiv_ui(q0, 3));
+  }
+
+  fmpz_t p0;  fmpz_init(p0);
+  uint64_t t = oz_walltime(0);
+  const int found0 = fmpz_next_probabprime_ap(p0, q0, s, count);
+  t = oz_walltime(t);
+
+  /* sequential walk */
+  fmpz_t p1;  fmpz_init(p1);
+  fmpz_set(p1, q0);
+  int found1 = 0;
+  for(ulong i=0; !found1 && (count == 0 || i < count); i++) {
+    if (fmpz_is_probabprime(p1))
+      found1 = 1;
+    else if (s > 0)
+      fmpz_add_ui(p1, p1, s);
+    else
+      fmpz_sub_ui(p1, p1, -s);
+  }
+
+  int r = (found0 == found1);
+  if (found0 && found1)
+    r &= fmpz_equal(p0, p1);
+
+  printf("log(q0): %6ld, s: %6ld, count: %6lu, found: %d, t: %7.4fs ", fmpz_sizeinbase(q0,2), s, count,
+         found0, oz_seconds(t));
+  if (r)
+    printf(" PASS\n");
+  else
+    printf(" FAIL\n");
+
+  fmpz_clear(p1);
+  fmpz_clear(p0);
+  fmpz_clear(q0);
+  return !r;
+}
+
 int main(int argc, char *argv[]) {
 
   aes_randstate_t state;
@@ -132,6 +427,35 @@ int main(int argc, char *argv[]) {
     status += test_fmpz_mod_poly_oz_mul_fftnwc(n, n/2, state);
   }
 
+  for(int i=0; bits[i]; i++) {
+    unsigned long n = ((unsigned long)1)<<bits[i];
+    status += test_fmpz_mod_poly_oz_mul_rns(n, n/2, state);
+  }
+
+  for(int i=0; bits[i]; i++) {
+    unsigned long n = ((unsigned long)1)<<bits[i];
+    status += test_fmpz_mod_poly_oz_ntt_ws(n, n/2, 16, state);
+  }
+
+  for(int i=0; bits[i]; i++) {
+    unsigned long n = ((unsigned long)1)<<bits[i];
+    status += test_fmpz_mod_poly_oz_ntt_inv(n, n/2, state);
+  }
+
+  mp_bitcnt_t qbits[6] = {20,64,65,600,4000,0};
+  for(int i=0; qbits[i]; i++) {
+    status += test_fmpz_oz_limb_mulmod(qbits[i], 0, 256, state);
+    status += test_fmpz_oz_limb_mulmod(qbits[i], 1, 256, state);
+  }
+
+  /* q0 below FMPZ_SIEVE_BOUND is not sieved */
+  status += test_fmpz_next_probabprime_ap(10, 2, 0, 1, state);
+  status += test_fmpz_next_probabprime_ap(10, -2, 256, 1, state);
+  status += test_fmpz_next_probabprime_ap(600, 2, 0, 1, state);
+  status += test_fmpz_next_probabprime_ap(600, -2048, 4096, 1, state);
+  status += test_fmpz_next_probabprime_ap(600, 2, 8, 1, state);
+  status += test_fmpz_next_probabprime_ap(600, -6, 64, 0, state);
+
   for(int i=0; bits[i]; i++) {
     unsigned long n = ((unsigned long)1)<<bits[i];
     for(unsigned long q=n_nextprime(n,0); q<n+100; q = n_nextprime(q, 0)) {